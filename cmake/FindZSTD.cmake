@@ -0,0 +1,30 @@
+# - Find zstd
+#   Find the zstd includes and library
+# This module defines
+#  ZSTD_INCLUDE_DIR
+#  ZSTD_LIBRARIES
+#  ZSTD_FOUND
+
+include (FindPackageHandleStandardArgs)
+
+find_path(
+  ZSTD_INCLUDE_DIR
+  NAMES zstd.h
+  PATHS
+    ${CMAKE_INSTALL_PREFIX}/include
+    /usr/local/include
+    /usr/include
+  DOC "zstd include directories"
+  )
+mark_as_advanced (ZSTD_INCLUDE_DIR)
+
+find_library (ZSTD_LIBRARIES
+  NAMES zstd
+  DOC "zstd library"
+  )
+mark_as_advanced (ZSTD_LIBRARIES)
+
+FIND_PACKAGE_HANDLE_STANDARD_ARGS("ZSTD"
+  REQUIRED_VARS ZSTD_LIBRARIES ZSTD_INCLUDE_DIR
+  FAIL_MESSAGE "zstd couldn't be found, .zst input is disabled"
+  )
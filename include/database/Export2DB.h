@@ -22,8 +22,9 @@
 #ifndef SRC_EXPORT2DB_H_
 #define SRC_EXPORT2DB_H_
 
-#include <pqxx/pqxx>
 #include <libpq-fe.h>
+#include <atomic>
+#include <functional>
 #include <map>
 #include <vector>
 #include <string>
@@ -34,6 +35,11 @@
 #include "configuration/configuration.h"
 #include "utilities/prog_options.h"
 #include "database/table_management.h"
+#include "database/connection_pool.h"
+#include "database/edge_keys.h"
+#include "database/vertex_degrees.h"
+#include "database/vertex_ids.h"
+#include "utilities/copy_buffer.h"
 
 namespace osm2pgr {
 
@@ -47,6 +53,12 @@ class Export2DB {
      typedef std::vector<Node> Nodes;
      typedef std::vector<Way> Ways;
      typedef std::vector<Relation> Relations;
+     /**
+      * finds the nodes of a way that were not linked while parsing
+      * (flat nodes): the nodes are kept in the first vector and
+      * the second one points to them, in the order of the way
+      */
+     typedef std::function<void(const Way&, Nodes&, std::vector<Node*>&)> NodeResolver;
 
      /**
       * Constructor 
@@ -90,22 +102,29 @@ class Export2DB {
                  const std::string &table) const {
              auto osm_table = m_tables.get_table(table);
              std::vector<std::string> values(items.size(), "");
+             CopyBuffer row(binary_copy());
 
              size_t i(0);
              for (auto it = items.begin(); it != items.end(); ++it, ++i) {
-                 auto item = *it;
-                 values[i] = tab_separated(item.values(osm_table.columns(), true));
+                 it->copy_values(osm_table.columns(), row);
+                 values[i] = row.release();
              }
 
-             export_osm(values, osm_table);
+             export_osm(values, osm_table, binary_copy());
          }
 
      void export_configuration(
              const std::map<std::string, Tag_key>& items) const;
 
-     void exportWays(
+     /** @brief the ways, their vertices and the pieces of the rows
+      *
+      * @returns false when a COPY of the rows failed: the vertices, the pieces
+      *          and the CSR graph are not written
+      */
+     bool exportWays(
              const Ways &ways,
-             const Configuration &config) const;
+             const Configuration &config,
+             const NodeResolver &resolve = nullptr) const;
 
      void dropTables() const;
      void createFKeys() const;
@@ -114,21 +133,51 @@ class Export2DB {
 
  private:
 
+     /** @param[in] values rows, written by a CopyBuffer
+      *  @param[in] binary the rows are in the binary COPY format
+      */
      void export_osm(
              const std::vector<std::string> &values,
-             const Table &table) const;
+             const Table &table,
+             bool binary = false) const;
+
+     //! binary COPY unless --text-copy
+     bool binary_copy() const {return !m_vm.count("text-copy");}
+
+     //! --bulk and the ways table is empty
+     bool bulk_load() const;
+
+     /** @brief copies the rows of the ways [start, limit) into the ways table
+      *
+      * @param[in] rows written by WayRows, with header and trailer
+      * @returns false when the rows were not committed
+      */
+     bool copy_ways_chunk(CopyBuffer &rows, size_t start, size_t limit) const;
+
+     //! the vertices on the table keep their ids
+     void load_vertices(VertexIds &vertices) const;
+
+     //! the splits on the ways table, or merged into its rows by --contract, are not written again
+     void load_edges(EdgeKeys &edges) const;
 
-     void process_section(const std::string &ways_columns, pqxx::work &Xaction) const;
+     //! @returns true when the ways had foreign keys on the vertices
+     bool drop_vertex_fkeys() const;
 
-     void fill_vertices_table(
-             const std::string &table,
-             const std::string &vertices_tab,
-             pqxx::work &Xaction) const;
+     /** @brief COPY the vertices added by this run
+      *
+      * @param degrees cnt, chk, ein and eout of the vertices
+      * @param components the component of each vertex added, empty without --components
+      */
+     void export_vertices(
+             const VertexIds &vertices,
+             const VertexDegrees &degrees,
+             const std::vector<int64_t> &components) const;
 
-     void fill_source_target(
-             const std::string &table,
-             const std::string &vertices_tab,
-             pqxx::work &Xaction) const;
+     //! cnt, ein and eout of the vertices of the table reached by this run, counted on the ways
+     void update_degrees(const VertexDegrees &degrees) const;
+
+     //! COPY the rows of the pieces table (--contract), with header and trailer
+     void export_pieces(CopyBuffer &rows, size_t count) const;
 
      int64_t get_val(const std::string sql) const;
      void execute(const std::string sql) const;
@@ -140,6 +189,7 @@ class Export2DB {
      Table osm_ways() const {return m_tables.osm_ways();}
      Table osm_nodes() const {return m_tables.osm_nodes();}
      Table osm_relations() const {return m_tables.osm_relations();}
+     Table pieces() const {return m_tables.pieces();}
 
  private:
      po::variables_map m_vm;
@@ -148,6 +198,11 @@ class Export2DB {
 
      Tables m_tables;
 
+     //! sessions reused by all the methods, const or not
+     mutable ConnectionPool m_pool;
+
+     //! numbers the temporary tables of the chunks of the osm tables exported concurrently
+     mutable std::atomic<size_t> m_temp_tables;
 };
 }  // namespace osm2pgr
 
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_COMPONENTS_H_
+#define SRC_COMPONENTS_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief connected components of the rows of the ways (--components, --prune)
+ *
+ * Union-find on the vertices, by their node osm_id: the rows join
+ * their source and target, without looking at the costs, as
+ * pgr_connectedComponents on an undirected graph.
+ *
+ * Only the rows of this run are joined: the rows of an earlier import
+ * are not read.
+ */
+class Components {
+ public:
+     Components() : m_components(0) {}
+
+     //! the row from source to target
+     void add(int64_t source_osm, int64_t target_osm);
+
+     //! the component of a vertex added, an index below size()
+     size_t find(int64_t osm_id);
+
+     //! number of vertices of a component found by find()
+     size_t vertices(size_t component) const {return m_size[component];}
+
+     //! components and vertices
+     size_t size() const {return m_components;}
+     size_t vertices() const {return m_parent.size();}
+
+     //! number of components by size, in decades: 1-9, 10-99, ... vertices, and the largest one
+     void print(std::ostream &out);
+
+ private:
+     size_t index(int64_t osm_id);
+     size_t root(size_t vertex);
+
+     std::unordered_map<int64_t, size_t> m_index;
+     std::vector<size_t> m_parent;
+     //! vertices of the components, read on the roots
+     std::vector<size_t> m_size;
+     size_t m_components;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_COMPONENTS_H_
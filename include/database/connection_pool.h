@@ -0,0 +1,147 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_CONNECTION_POOL_H_
+#define SRC_CONNECTION_POOL_H_
+#pragma once
+
+#include <libpq-fe.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief result of a statement, cleared with its last copy */
+class SqlResult {
+ public:
+     explicit SqlResult(PGresult *result) : m_result(result, PQclear) {}
+
+     //! command tag: INSERT, COMMIT, ...
+     std::string status() const {return PQcmdStatus(m_result.get());}
+     //! rows returned
+     size_t size() const {return static_cast<size_t>(PQntuples(m_result.get()));}
+     //! rows inserted, updated or deleted
+     size_t affected_rows() const;
+
+     bool is_null(size_t row, int column) const {
+         return PQgetisnull(m_result.get(), static_cast<int>(row), column) == 1;
+     }
+     std::string get(size_t row, int column) const {
+         return PQgetvalue(m_result.get(), static_cast<int>(row), column);
+     }
+     int64_t get_int64(size_t row, int column) const;
+
+ private:
+     std::shared_ptr<PGresult> m_result;
+};
+
+
+/** @brief sessions to the database, opened once and reused
+ *
+ * A session is leased by acquire() and goes back to the pool when the
+ * lease is destroyed; a new connection is opened only when no session
+ * is idle. The connections are closed with the pool.
+ *
+ * acquire() is thread safe, a session is used by one thread at a time.
+ */
+class ConnectionPool {
+ public:
+     //! a leased session
+     class Session {
+      public:
+          Session(Session &&other);
+          Session(const Session&) = delete;
+          Session& operator=(const Session&) = delete;
+          ~Session();
+
+          PGconn* get() const {return m_conn;}
+
+          /** @brief runs the statements
+           *
+           * @returns the result of the last one
+           * @throws std::runtime_error with the message of the server
+           */
+          SqlResult exec(const std::string &sql);
+
+      private:
+          friend class ConnectionPool;
+          Session(ConnectionPool *pool, PGconn *conn) :
+              m_pool(pool),
+              m_conn(conn) {}
+
+          ConnectionPool *m_pool;
+          PGconn *m_conn;
+     };
+
+     explicit ConnectionPool(const std::string &conninfo) :
+         m_conninfo(conninfo),
+         m_opened(0) {}
+     ConnectionPool(const ConnectionPool&) = delete;
+     ConnectionPool& operator=(const ConnectionPool&) = delete;
+     ~ConnectionPool();
+
+     /** @brief an idle session, or a new connection
+      *
+      * @throws std::runtime_error when the connection fails
+      */
+     Session acquire();
+
+     //! connections opened during the run
+     size_t opened() const;
+
+ private:
+     void release(PGconn *conn);
+
+     std::string m_conninfo;
+     mutable std::mutex m_mutex;
+     std::vector<PGconn*> m_idle;
+     size_t m_opened;
+};
+
+
+/** @brief BEGIN ... COMMIT on a session
+ *
+ * Rolled back when destroyed without commit(), like pqxx::work.
+ */
+class Transaction {
+ public:
+     explicit Transaction(ConnectionPool::Session &session);
+     Transaction(const Transaction&) = delete;
+     Transaction& operator=(const Transaction&) = delete;
+     ~Transaction();
+
+     SqlResult exec(const std::string &sql) {return m_session.exec(sql);}
+     void commit();
+
+ private:
+     ConnectionPool::Session &m_session;
+     bool m_open;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_CONNECTION_POOL_H_
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_EDGE_KEYS_H_
+#define SRC_EDGE_KEYS_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "osm_elements/Node.h"
+
+namespace osm2pgr {
+
+/** @brief the split ways already written
+ *
+ * A split is a duplicate when:
+ * - its sequence of node ids was written before by this run: the same
+ *   geometry, point by point, as ST_OrderingEquals
+ * - or the ways table of an earlier import has a row with the same
+ *   osm_id, source_osm and target_osm
+ *
+ * The keys are kept in full: the node ids of the splits one after the
+ * other in an array, the osm_id, source_osm and target_osm of the rows
+ * in another. Open addressing tables of their 64 bit hashes find them,
+ * and a hash found is a duplicate only when its key is the same: two
+ * splits whose hashes collide are both written.
+ */
+class EdgeKeys {
+ public:
+     EdgeKeys() : m_duplicates(0) {}
+
+     //! a row of the ways table
+     void add_existing(int64_t osm_id, int64_t source_osm, int64_t target_osm);
+
+     /** @brief true the first time the split is seen
+      *
+      * @param[in] osm_id of the way
+      * @param[in] nodeRefs the nodes of the way, the split is [first, last]
+      */
+     bool insert(
+             int64_t osm_id,
+             const std::vector<Node*> &nodeRefs,
+             size_t first, size_t last);
+
+     //! splits found already written
+     size_t duplicates() const {return m_duplicates;}
+
+ private:
+     //! hashes of keys kept by the EdgeKeys, each with the position of its key
+     class KeySet {
+      public:
+          static const uint64_t npos = UINT64_MAX;
+
+          KeySet() : m_size(0) {}
+          void insert(uint64_t hash, uint64_t position);
+          bool empty() const {return m_size == 0;}
+
+          /** @returns the position of a key with the hash for which equal(position) is true, or npos */
+          template <typename Equal>
+          uint64_t find(uint64_t hash, const Equal &equal) const {
+              if (m_slots.empty()) return npos;
+              auto mask = m_slots.size() - 1;
+              for (auto i = static_cast<size_t>(hash) & mask; m_slots[i].position != npos; i = (i + 1) & mask) {
+                  if (m_slots[i].hash == hash && equal(m_slots[i].position)) return m_slots[i].position;
+              }
+              return npos;
+          }
+
+      private:
+          struct Slot {
+              uint64_t hash;
+              //! npos marks an empty slot
+              uint64_t position;
+          };
+
+          void grow();
+
+          std::vector<Slot> m_slots;
+          size_t m_size;
+     };
+
+     KeySet m_nodes;
+     //! for each split: the number of nodes, then their ids
+     std::vector<int64_t> m_node_ids;
+     KeySet m_existing;
+     //! osm_id, source_osm, target_osm of each row
+     std::vector<int64_t> m_segments;
+     size_t m_duplicates;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_EDGE_KEYS_H_
@@ -0,0 +1,189 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_KEPT_SPLITS_H_
+#define SRC_KEPT_SPLITS_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "osm_elements/Node.h"
+#include "osm_elements/Way.h"
+#include "database/components.h"
+#include "database/vertex_ids.h"
+#include "database/way_chains.h"
+#include "database/way_rows.h"
+#include "utilities/copy_buffer.h"
+#include "utilities/csr_graph.h"
+
+namespace osm2pgr {
+
+/** @brief the splits kept, gathered before they are numbered (--hilbert, --contract, --components)
+ *
+ * The rows follow chains of splits, one split each without --contract.
+ * The steps are called in this order, each one optional but gather()
+ * and one of single() or contract():
+ * - gather(): the splits kept by the WayRows, in the order of the ways
+ * - single() or contract(): the chains, contract() merges the splits
+ *   through vertices of degree 2, a row per chain
+ * - components(): joins the chains in connected components and, with
+ *   a prune size, drops the small ones
+ * - hilbert(): sorts the chains along a Hilbert curve, by the middle of
+ *   their end nodes; the new vertices take their ids in the order of the
+ *   curve too
+ * - label_components(): the component of each chain and new vertex
+ *
+ * Then the rows are numbered and written by chain, as the WayRows do
+ * for the splits of a way.
+ */
+class KeptSplits {
+ public:
+     typedef std::function<void(const Way&, std::vector<Node>&, std::vector<Node*>&)> Resolver;
+
+     //! the nodes of the pieces of a row, reused by the rows written by a thread
+     struct Pieces {
+         std::vector<WayRows::Piece> pieces;
+         std::deque<std::pair<std::vector<Node>, std::vector<Node*>>> nodes;
+     };
+
+     /**
+      * @param ways the ways of the rows
+      * @param resolve when given, gives the nodes of a way
+      */
+     KeptSplits(const std::vector<Way> &ways, const Resolver &resolve) :
+         m_ways(ways),
+         m_resolve(resolve),
+         m_contracted(false),
+         m_has_components(false),
+         m_pruned_components(0),
+         m_pruned_rows(0) {}
+
+     //! the splits kept by the WayRows, not numbered
+     void gather(WayRows &way_rows);
+
+     //! one chain per split
+     void single();
+
+     /** @brief merges the splits through vertices of degree 2
+      *
+      * The vertices on the table are kept: rows of earlier imports end there.
+      */
+     void contract(const VertexIds &vertex_ids, std::ostream &out);
+
+     /** @brief the connected components of the chains
+      *
+      * @param[in] vertex_ids the components reaching the vertices on the table are not pruned
+      * @param[in] prune when not 0, the chains of smaller components are dropped
+      */
+     void components(const VertexIds &vertex_ids, size_t prune, std::ostream &out);
+
+     //! sorts the chains along a Hilbert curve and gives the ids of their new vertices
+     void hilbert(VertexIds &vertex_ids, std::ostream &out);
+
+     /** @brief the component of the chains: the smallest vertex id in it
+      *
+      * The vertices take their ids here, in the order the rows would give them.
+      *
+      * @returns the component of each vertex added by this run
+      */
+     std::vector<int64_t> label_components(VertexIds &vertex_ids);
+
+     //! number of chains, the rows
+     size_t size() const {return m_chains.size();}
+
+     //! the row is driven as the way of its first split
+     const Way& way(size_t chain) const {return m_ways[m_kept[m_links[m_chains[chain].first].split].way];}
+
+     /** @brief gives the next gid, source and target to the row of a chain
+      *
+      * @param[out] splits the split of the row is appended
+      */
+     void number(size_t chain, WayRows &way_rows, std::vector<WayRows::Split> &splits) const;
+
+     /** @brief the rows of the pieces table for a contracted chain
+      *
+      * @param[in] split numbered by number()
+      * @returns the number of rows appended
+      */
+     size_t pieces(size_t chain, const WayRows::Split &split, CopyBuffer &rows) const;
+
+     /** @brief the row of a chain, numbered by number()
+      *
+      * Thread safe as WayRows::write().
+      */
+     void write(
+             size_t chain,
+             const WayRows::Split &split,
+             const WayRows &way_rows,
+             CopyBuffer &rows,
+             WayRows::Coordinates &coordinates,
+             Pieces &pieces,
+             std::vector<CsrGraph::Edge> *edges) const;
+
+     bool contracted() const {return m_contracted;}
+     //! dropped by components()
+     size_t pruned_components() const {return m_pruned_components;}
+     size_t pruned_rows() const {return m_pruned_rows;}
+
+ private:
+     struct Kept {
+         size_t way;
+         WayRows::Split split;
+         VertexIds::Vertex source;
+         VertexIds::Vertex target;
+     };
+
+     struct Chain {
+         uint64_t key;
+         //! m_links[first, first + size)
+         size_t first;
+         size_t size;
+         //! smallest vertex id of the component, with components()
+         int64_t component;
+     };
+
+     //! the ends of a chain, in its direction
+     const VertexIds::Vertex& source(const Chain &chain) const;
+     const VertexIds::Vertex& target(const Chain &chain) const;
+
+ private:
+     const std::vector<Way> &m_ways;
+     Resolver m_resolve;
+     std::vector<Kept> m_kept;
+     std::vector<WayChains::Link> m_links;
+     std::vector<Chain> m_chains;
+     bool m_contracted;
+     Components m_components;
+     bool m_has_components;
+     size_t m_pruned_components;
+     size_t m_pruned_rows;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_KEPT_SPLITS_H_
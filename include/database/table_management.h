@@ -83,6 +83,11 @@ class Table {
          m_sql.push_back(sql);
      }
 
+     /** the temporary tables of concurrent exports need distinct names */
+     void temp_suffix(const std::string &suffix) {
+         m_temp_suffix = suffix;
+     }
+
  private:
      std::string m_name;
      std::string m_schema;
@@ -93,6 +98,7 @@ class Table {
      std::string m_constraint;
      std::string m_geometry;
      std::vector<std::string> m_columns;
+     std::string m_temp_suffix;
 
      /** aditional sqls (for pois) to keep code clean*/
      std::vector<std::string> m_sql;
@@ -136,6 +142,7 @@ class Tables {
         Table m_osm_nodes;
         Table m_osm_ways;
         Table m_osm_relations;
+        Table m_ways_pieces;
 
     public:
         const Table& ways() const {return m_ways;}
@@ -145,6 +152,7 @@ class Tables {
         const Table& osm_nodes() const {return m_osm_nodes;}
         const Table& osm_ways() const {return m_osm_ways;}
         const Table& osm_relations() const {return m_osm_relations;}
+        const Table& pieces() const {return m_ways_pieces;}
 
     private:
         Table osm_nodes_config() const;
@@ -154,6 +162,7 @@ class Tables {
         Table configuration_config() const;
         Table ways_config() const;
         Table ways_vertices_pgr_config() const;
+        Table ways_pieces_config() const;
 };
 
 }
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SRC_VERTEX_DEGREES_H_
+#define SRC_VERTEX_DEGREES_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief cnt, chk, ein and eout of the vertices, counted while the rows are numbered
+ *
+ * The columns pgr_analyzeGraph and pgr_analyzeOneWay fill:
+ * - cnt: rows reaching the vertex, 1 on a dead end
+ * - ein, eout: rows that can be driven into and out of the vertex, by their one_way
+ * - chk: 1 when a row of the vertex has zero length or repeats a node
+ *
+ * A row from a vertex to itself counts twice, as in pgRouting.
+ * The vertices added by this run are kept by id, the ones already on
+ * the table apart: their columns are counted again on the table.
+ */
+class VertexDegrees {
+ public:
+     struct Degree {
+         int32_t cnt;
+         int32_t chk;
+         int32_t ein;
+         int32_t eout;
+     };
+
+     //! @param first_added id of the first vertex added by this run
+     explicit VertexDegrees(int64_t first_added) :
+         m_first(first_added),
+         m_zero_length(0),
+         m_repeated_nodes(0) {}
+
+     /** @brief the row from source to target
+      *
+      * @param forward the row can be driven from source to target
+      * @param backward the row can be driven from target to source
+      * @param zero_length all the nodes of the row are at the same place
+      * @param repeated_nodes a node of the row follows itself
+      */
+     void add(int64_t source, int64_t target, bool forward, bool backward,
+             bool zero_length, bool repeated_nodes);
+
+     //! the vertex added by this run, zeros when no row reached it
+     const Degree& added(int64_t id) const;
+
+     //! the vertices of the table reached by the rows of this run
+     const std::unordered_map<int64_t, Degree>& existing() const {return m_existing;}
+
+     //! dead ends, vertices that can not be left or reached, rows flagged
+     void print(std::ostream &out) const;
+
+ private:
+     Degree& degree(int64_t id);
+
+     int64_t m_first;
+     std::vector<Degree> m_added;
+     std::unordered_map<int64_t, Degree> m_existing;
+     size_t m_zero_length;
+     size_t m_repeated_nodes;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_VERTEX_DEGREES_H_
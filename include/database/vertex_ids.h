@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_VERTEX_IDS_H_
+#define SRC_VERTEX_IDS_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "osm_elements/Node.h"
+
+namespace osm2pgr {
+
+/** @brief ids of the vertices table
+ *
+ * The vertices are the end nodes of the split ways: the first node to
+ * reach a vertex gives it the next id, so source and target are known
+ * while the ways are written and the vertices table is loaded once,
+ * after the ways.
+ *
+ * The vertices already on the table (an import without --clean) are
+ * read first and keep their ids.
+ */
+class VertexIds {
+ public:
+     //! a vertex added by this run
+     struct Vertex {
+         int64_t osm_id;
+         int32_t lat;
+         int32_t lon;
+     };
+
+     VertexIds() : m_first(1) {}
+
+     //! a vertex that is on the table
+     void add_existing(int64_t osm_id, int64_t id);
+
+     //! id of the vertex of the node, a new vertex when first seen
+     int64_t id(const Node &node) {
+         auto found = m_ids.find(node.osm_id());
+         if (found != m_ids.end()) return found->second;
+         auto id = m_first + static_cast<int64_t>(m_added.size());
+         m_ids.emplace(node.osm_id(), id);
+         m_added.push_back(Vertex{node.osm_id(), node.lat_e7(), node.lon_e7()});
+         return id;
+     }
+
+     //! the node is a vertex, existing or added
+     bool has(int64_t osm_id) const {return m_ids.count(osm_id) != 0;}
+
+     //! the vertices added by this run, their ids follow first_added()
+     const std::vector<Vertex>& added() const {return m_added;}
+     int64_t first_added() const {return m_first;}
+
+     //! all the vertices: existing and added
+     size_t size() const {return m_ids.size();}
+
+ private:
+     std::unordered_map<int64_t, int64_t> m_ids;
+     std::vector<Vertex> m_added;
+     //! id of m_added[0]
+     int64_t m_first;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_VERTEX_IDS_H_
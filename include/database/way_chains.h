@@ -0,0 +1,126 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_WAY_CHAINS_H_
+#define SRC_WAY_CHAINS_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "osm_elements/Way.h"
+#include "database/way_rows.h"
+
+namespace osm2pgr {
+
+/** @brief chains of split ways through vertices of degree 2 (--contract)
+ *
+ * A vertex where exactly two splits meet, coming from different ways or
+ * not, is removed when the splits have the same attributes in the
+ * direction of the chain: each chain becomes one row of the ways table.
+ *
+ * The vertices kept are the ends of the chains: junctions, dead ends,
+ * changes of attributes, and the vertices given as fixed (already on
+ * the vertices table). A closed chain keeps the first node of its
+ * first split.
+ */
+class WayChains {
+ public:
+     //! the columns that must match along a chain, in the direction of a split
+     struct Attributes {
+         int32_t tag_id;
+         int one_way;
+         double maxspeed_forward;
+         double maxspeed_backward;
+
+         //! the same split, walked from its last node to its first
+         Attributes reversed() const;
+         bool operator==(const Attributes &other) const;
+     };
+
+     //! a split in a chain, walked from its last node to its first when reversed
+     struct Link {
+         size_t split;
+         bool reversed;
+     };
+
+     WayChains() : m_removed(0) {}
+
+     static Attributes attributes(const Way &way, const WayRows::Split &split);
+
+     //! the splits, numbered in the order they are added
+     void add(int64_t source_osm, int64_t target_osm, const Attributes &attributes);
+
+     /** @brief finds the chains
+      *
+      * @param[in] fixed the vertices that can not be removed
+      */
+     void build(const std::function<bool(int64_t)> &fixed);
+
+     //! number of chains
+     size_t size() const {return m_chains.empty() ? 0 : m_chains.size() - 1;}
+
+     //! the links of a chain, in the order of the chain, the first one not reversed
+     const Link* links(size_t chain) const {return m_links.data() + m_chains[chain];}
+     size_t links_size(size_t chain) const {return m_chains[chain + 1] - m_chains[chain];}
+
+     //! vertices removed by build()
+     size_t removed() const {return m_removed;}
+
+ private:
+     struct Split {
+         int64_t node[2];
+         Attributes attributes;
+     };
+
+     //! the splits meeting at a vertex, the first two of them
+     struct Vertex {
+         uint32_t degree;
+         bool removable;
+         size_t split[2];
+         //! 0: the first node of the split, 1: its last node
+         int end[2];
+     };
+
+     //! the split after (or before) the link in its chain
+     bool next(const Link &link, Link &next) const;
+     bool previous(const Link &link, Link &previous) const;
+     //! the vertex joins two splits of a chain
+     bool removable(int64_t node, const Vertex &vertex, const std::function<bool(int64_t)> &fixed) const;
+     //! the other split of a removable vertex
+     size_t other(const Vertex &vertex, size_t split) const {return vertex.split[0] == split ? 1 : 0;}
+
+     std::vector<Split> m_splits;
+     std::unordered_map<int64_t, Vertex> m_vertices;
+
+     std::vector<Link> m_links;
+     //! chain c is m_links[m_chains[c], m_chains[c + 1])
+     std::vector<size_t> m_chains;
+     size_t m_removed;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_WAY_CHAINS_H_
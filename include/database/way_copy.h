@@ -0,0 +1,155 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_WAY_COPY_H_
+#define SRC_WAY_COPY_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "osm_elements/Node.h"
+#include "osm_elements/Way.h"
+#include "database/kept_splits.h"
+#include "database/vertex_degrees.h"
+#include "database/way_rows.h"
+#include "utilities/copy_buffer.h"
+#include "utilities/csr_graph.h"
+#include "utilities/thread_pool.h"
+
+namespace osm2pgr {
+
+/** @brief numbers and writes the rows of the ways table
+ *
+ * The rows of a range of ways, or of chains when the splits were
+ * gathered by a KeptSplits, in their order.
+ *
+ * The splits are numbered on the calling thread, in the order of the
+ * ways, and their degrees counted. With more than one split thread the
+ * rows of batches of ways are written by a pool, the batches appended
+ * in order: the rows are the same as with one thread.
+ */
+class WayCopy {
+ public:
+     typedef KeptSplits::Resolver Resolver;
+     //! takes the rows written so far, when they are big enough; false when they were not taken
+     typedef std::function<bool(CopyBuffer&)> Sink;
+
+     /**
+      * @param ways the ways of the rows
+      * @param resolve when given, gives the nodes of a way
+      * @param way_rows numbers and writes the splits
+      * @param degrees counts the degrees of the rows numbered
+      * @param chains when given, the rows are the ones of its chains
+      * @param binary the rows of the pieces table are in binary
+      * @param split_threads threads writing the rows, 1: the calling thread
+      * @param csr the edges of the rows are kept
+      */
+     WayCopy(
+             const std::vector<Way> &ways,
+             const Resolver &resolve,
+             WayRows &way_rows,
+             VertexDegrees &degrees,
+             const KeptSplits *chains,
+             bool binary,
+             size_t split_threads,
+             bool csr);
+
+     //! number of ways, or of chains
+     size_t size() const {return m_chains ? m_chains->size() : m_ways.size();}
+
+     /** @brief the rows of the ways (or chains) [start, limit)
+      *
+      * @param[out] rows
+      * @param[in] send when given, called as the rows are appended
+      * @returns false when send did not take the rows: stops at the first failure
+      */
+     bool copy(CopyBuffer &rows, size_t start, size_t limit, const Sink &send = nullptr);
+
+     //! ways (or chains) and splits numbered
+     int64_t count() const {return m_count;}
+     int64_t split_count() const {return m_split_count;}
+
+     //! the edges of the rows, with csr
+     const std::vector<CsrGraph::Edge>& edges() const {return m_edges;}
+
+     //! rows of the pieces table, when the chains are contracted
+     CopyBuffer& piece_rows() {return m_piece_rows;}
+     size_t piece_count() const {return m_piece_count;}
+
+ private:
+     //! the splits numbered of the ways of a batch, written by the pool
+     struct Batch {
+         //! index of the way (or of the chain), number of its splits
+         std::vector<std::pair<size_t, size_t>> ways;
+         std::vector<WayRows::Split> splits;
+         std::vector<CsrGraph::Edge> edges;
+     };
+
+     //! the splits of the i-th way, numbered
+     size_t number(size_t i, const std::vector<Node*> &nodeRefs, std::vector<WayRows::Split> &splits);
+     //! the row of the i-th chain, numbered
+     void number(size_t i, std::vector<WayRows::Split> &splits);
+     //! the row is driven as its way
+     void add_degrees(const Way &way, const WayRows::Split &split);
+
+     //! the rows of a batch, on a thread of the pool
+     CopyBuffer write(Batch &batch) const;
+     //! the rows of the first batch pending appended, and their edges
+     void append_front(CopyBuffer &rows);
+
+ private:
+     const std::vector<Way> &m_ways;
+     Resolver m_resolve;
+     WayRows &m_way_rows;
+     VertexDegrees &m_degrees;
+     const KeptSplits *m_chains;
+     bool m_binary;
+     bool m_csr;
+
+     int64_t m_count;
+     int64_t m_split_count;
+     std::vector<CsrGraph::Edge> m_edges;
+     CopyBuffer m_piece_rows;
+     size_t m_piece_count;
+
+     //! used by the calling thread
+     std::vector<Node> m_nodes;
+     std::vector<Node*> m_refs;
+     std::vector<WayRows::Split> m_splits;
+     WayRows::Coordinates m_coordinates;
+     KeptSplits::Pieces m_pieces;
+
+     std::deque<std::pair<std::shared_ptr<Batch>, std::future<CopyBuffer>>> m_pending;
+     //! last: its workers are joined first
+     std::unique_ptr<ThreadPool> m_pool;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_WAY_COPY_H_
@@ -0,0 +1,241 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_WAY_ROWS_H_
+#define SRC_WAY_ROWS_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "osm_elements/Node.h"
+#include "osm_elements/Way.h"
+#include "configuration/configuration.h"
+#include "database/edge_keys.h"
+#include "database/vertex_ids.h"
+#include "utilities/copy_buffer.h"
+#include "utilities/csr_graph.h"
+
+namespace osm2pgr {
+
+/** @brief rows of the ways table
+ *
+ * One row per split of a way, in the columns of ways_config,
+ * appended to a CopyBuffer without building strings: once the buffer
+ * and the split bounds have grown, a row does not allocate.
+ *
+ * source and target are the ids given by the VertexIds to the end
+ * nodes of the split; length_m, cost_s and reverse_cost_s are the
+ * geodesic length and the travel times at the maxspeeds.
+ *
+ * The splits already written, as told by the EdgeKeys, are skipped.
+ * The gids are given in the order of the rows: the same input gives
+ * the same gids, whichever connection copies the rows.
+ *
+ * add() does both steps of a way:
+ * - number(): the splits kept, their gid, source and target, in the
+ *   order of the rows (the state is shared: one thread)
+ * - write(): the rows of numbered splits, read only, so the ways can
+ *   be written by several threads and the rows appended in order
+ *
+ * number() is keep() and number(Split&): the splits kept can be sorted
+ * before they are numbered. keep() flags the splits of zero length and
+ * the ones repeating a node, for the chk column of the vertices.
+ */
+class WayRows {
+ public:
+     //! values of the configuration, read once per tag
+     struct Tag_columns {
+         int32_t tag_id;
+         double maxspeed_forward;
+         double maxspeed_backward;
+         double priority;
+     };
+
+     //! a split of a way, numbered
+     struct Split {
+         //! the split is nodeRefs[first, last]
+         size_t first;
+         size_t last;
+         int64_t gid;
+         int64_t source;
+         int64_t target;
+         //! kept by the WayRows, while it lives
+         const Tag_columns *tag;
+         //! written when the rows have a component column
+         int64_t component;
+         //! all the nodes at the same place: the length is 0
+         bool zero_length;
+         //! a node follows itself
+         bool repeated_nodes;
+     };
+
+     //! a split of a chain merged into one row (--contract)
+     struct Piece {
+         const Way *way;
+         const std::vector<Node*> *nodeRefs;
+         size_t first;
+         size_t last;
+         //! walked from last to first
+         bool reversed;
+     };
+
+     //! coordinates of a split, reused by the rows written by a thread
+     struct Coordinates {
+         std::vector<int32_t> lon;
+         std::vector<int32_t> lat;
+     };
+
+     /**
+      * @param last_gid the rows are numbered after it, usually the largest gid of the table
+      * @param components the rows end with the component of the splits
+      */
+     WayRows(const Configuration &config, VertexIds &vertices, EdgeKeys &edges, int64_t last_gid = 0,
+             bool components = false) :
+         m_config(config),
+         m_vertices(vertices),
+         m_edges(edges),
+         m_gid(last_gid),
+         m_components(components) {}
+
+     /** @brief appends the rows of the splits of the way
+      *
+      * @param[in] way with a tag of the configuration
+      * @param[in] nodeRefs the nodes of the way
+      * @param[out] rows
+      * @returns the number of splits written, the duplicates are skipped
+      */
+     size_t add(
+             const Way &way,
+             const std::vector<Node*> &nodeRefs,
+             CopyBuffer &rows);
+
+     /** @brief the splits of the way to write, in the order of the rows
+      *
+      * @param[in] way with a tag of the configuration
+      * @param[in] nodeRefs the nodes of the way
+      * @param[out] splits the splits kept are appended
+      * @returns the number of splits appended, the duplicates are skipped
+      */
+     size_t number(
+             const Way &way,
+             const std::vector<Node*> &nodeRefs,
+             std::vector<Split> &splits);
+
+     /** @brief the splits of the way to write, not numbered yet
+      *
+      * @param[in] way with a tag of the configuration
+      * @param[in] nodeRefs the nodes of the way
+      * @param[out] splits the splits kept are appended
+      * @returns the number of splits appended, the duplicates are skipped
+      */
+     size_t keep(
+             const Way &way,
+             const std::vector<Node*> &nodeRefs,
+             std::vector<Split> &splits);
+
+     /** @brief gives the next gid, source and target to a split kept
+      *
+      * @param[in,out] split kept by keep()
+      * @param[in] nodeRefs the nodes given to keep()
+      */
+     void number(Split &split, const std::vector<Node*> &nodeRefs);
+
+     //! gives the next gid to the row from source to target, and their vertex ids
+     void number(Split &split, const Node &source, const Node &target);
+
+     /** @brief the rows of splits numbered by number()
+      *
+      * Does not modify the WayRows: safe to call from several threads,
+      * each with its own rows and coordinates.
+      *
+      * @param[in] way
+      * @param[in] nodeRefs the nodes given to number()
+      * @param[in] splits numbered by number() for the way
+      * @param[in] count number of splits
+      * @param[out] rows
+      * @param[in,out] coordinates reused memory
+      * @param[out] edges when given, the edges of the rows are appended
+      */
+     void write(
+             const Way &way,
+             const std::vector<Node*> &nodeRefs,
+             const Split *splits, size_t count,
+             CopyBuffer &rows,
+             Coordinates &coordinates,
+             std::vector<CsrGraph::Edge> *edges = nullptr) const;
+
+     /** @brief the row of a chain of splits, merged into one edge
+      *
+      * The columns of the way are the ones of the first piece, which is
+      * not reversed; the geometry and the lengths are the ones of the
+      * whole chain. Thread safe as the other write().
+      *
+      * @param[in] pieces the splits of the chain, in order
+      * @param[in] count number of pieces
+      * @param[in] split numbered by number(Split&, source, target), its tag is the one of the first piece
+      * @param[out] rows
+      * @param[in,out] coordinates reused memory
+      * @param[out] edges when given, the edge of the row is appended
+      */
+     void write(
+             const Piece *pieces, size_t count,
+             const Split &split,
+             CopyBuffer &rows,
+             Coordinates &coordinates,
+             std::vector<CsrGraph::Edge> *edges = nullptr) const;
+
+     //! the gid of the last row written
+     int64_t last_gid() const {return m_gid;}
+
+ private:
+     const Tag_columns& tag_columns(const Tag &tag);
+
+     //! the row of the split from source to target along the coordinates
+     void write_row(
+             const Way &way,
+             const Split &split,
+             const Node &source, const Node &target,
+             double length,
+             const Coordinates &coordinates,
+             CopyBuffer &rows,
+             std::vector<CsrGraph::Edge> *edges) const;
+
+ private:
+     const Configuration &m_config;
+     VertexIds &m_vertices;
+     EdgeKeys &m_edges;
+     int64_t m_gid;
+     bool m_components;
+     //! the Tag_columns do not move when a tag is added
+     std::map<const Tag_value*, Tag_columns> m_tags;
+     std::vector<size_t> m_bounds;
+     //! used by add()
+     std::vector<Split> m_splits;
+     Coordinates m_coordinates;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_WAY_ROWS_H_
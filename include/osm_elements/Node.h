@@ -27,6 +27,8 @@
 #include <cstdint>
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
 #include "./osm_element.h"
 
 namespace osm2pgr {
@@ -58,24 +60,55 @@ class Tag;
       @endcode
       */
 
-class Node : public Element {
+class Node {
  public:
-     Node() = default;
-     Node(const Node&) = default;
+     Node() :
+         m_osm_id(0),
+         m_lat(0),
+         m_lon(0),
+         m_numsOfUse(0),
+         m_located(false) {}
+     Node(const Node &other);
+     Node(Node&&) = default;
+     Node& operator=(const Node &other);
+     Node& operator=(Node&&) = default;
      /**
-      *    @param atts attributes read py the parser
+      *    @param atts attributes read py the parser, a node without lat or lon is not located()
+      *    @param keep_attributes keep all the attributes, for the osm_nodes table
       */
-     explicit Node(const char **atts);
-     ~Node() {};
+     explicit Node(const char **atts, bool keep_attributes = false);
+     /**
+      *    @param osm_id id of the node
+      *    @param lat, lon 1e-7 degrees
+      */
+     Node(int64_t osm_id, int32_t lat, int32_t lon) :
+         m_osm_id(osm_id),
+         m_lat(lat),
+         m_lon(lon),
+         m_numsOfUse(0),
+         m_located(true) {}
+     ~Node() {}
 
-     inline std::string geom_str(const std::string separator) const {
-         return get_attribute("lon") + separator +  get_attribute("lat");
-     }
-     inline std::string lat() {return get_attribute("lat");}
-     inline std::string lon() {return get_attribute("lon");}
+     inline int64_t osm_id() const {return m_osm_id;}
 
-     void tag_config(const Tag &tag);
+     //! the node has its coordinates (the deleted nodes of a change file do not)
+     inline bool located() const {return m_located;}
+
+     /** @name coordinates
+      * stored as 1e-7 degrees fixed point, the precision of the OSM data
+      */
+     ///@{
+     inline int32_t lat_e7() const {return m_lat;}
+     inline int32_t lon_e7() const {return m_lon;}
+     inline double latitude() const {return m_lat / 1e7;}
+     inline double longitude() const {return m_lon / 1e7;}
+     inline std::string lat() const {return fixed_str(m_lat);}
+     inline std::string lon() const {return fixed_str(m_lon);}
+     ///@}
 
+     inline std::string geom_str(const std::string separator) const {
+         return lon() + separator + lat();
+     }
 
      std::string get_geometry() const {
          return
@@ -83,21 +116,54 @@ class Node : public Element {
              + geom_str(" ") + ")";
      }
 
-     inline std::string osm_id_str() {
+     inline std::string osm_id_str() const {
          return boost::lexical_cast<std::string>(m_osm_id);
      }
      double getLength(const Node &previous) const;
 
+     /** @name tags
+      * kept out of line, only the few nodes with tags pay for them
+      */
+     ///@{
+     Tag add_tag(const Tag &tag);
+     bool has_tags() const {return m_extra && m_extra->has_tags();}
+     bool has_tag(const std::string &key) const {return m_extra && m_extra->has_tag(key);}
+     std::string get_tag(const std::string &key) const {return m_extra->get_tag(key);}
+     const std::map<std::string, std::string>& tags() const;
+
+     void tag_config(const Tag &tag);
+     Tag tag_config() const {return m_extra ? m_extra->tag_config() : Tag();}
+     bool is_tag_configured() const {return m_extra && m_extra->is_tag_configured();}
+     ///@}
+
+     std::vector<std::string> values(
+             const std::vector<std::string> &columns,
+             bool is_hstore) const;
+     void copy_values(
+             const std::vector<std::string> &columns,
+             CopyBuffer &row) const;
 
      inline uint16_t incrementUse() {return ++m_numsOfUse;}
      inline uint16_t numsOfUse() const {return m_numsOfUse;}
      inline void numsOfUse(uint16_t val)  {m_numsOfUse = val;}
 
+     //! decimal degrees, without trailing zeros
+     static std::string fixed_str(int32_t value);
+
+ private:
+     Element& extra();
+
  private:
+     int64_t m_osm_id;
+     int32_t m_lat;
+     int32_t m_lon;
      /**
       *    counts the rate, how much this node is used in different ways
       */
      uint16_t m_numsOfUse;
+     bool m_located;
+     //! tags, configuration tag & attributes, null for most nodes
+     std::unique_ptr<Element> m_extra;
 };
 
 
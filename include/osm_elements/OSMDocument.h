@@ -24,10 +24,15 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <vector>
 #include "utilities/utilities.h"
 #include "configuration/configuration.h"
 #include "utilities/prog_options.h"
+#include "utilities/id_bitmap.h"
+#include "utilities/node_index.h"
+#include "utilities/flat_nodes.h"
+#include "utilities/export_queue.h"
 #include "database/Export2DB.h"
 
 namespace osm2pgr {
@@ -50,10 +55,7 @@ class OSMDocument {
     OSMDocument(
             const Configuration& config,
             const po::variables_map &vm,
-            const Export2DB &db_conn,
-            size_t lines);
-
-    inline size_t lines() const {return m_lines;}
+            const Export2DB &db_conn);
 
     //! Do the configuration has the @b tag ?
     inline bool config_has_tag(const Tag &tag) const {
@@ -68,18 +70,49 @@ class OSMDocument {
         return m_rConfig.maxspeed(tag);
     }
 
+    /**
+     * Only the nodes of the set are kept (two pass import),
+     * plus the tagged nodes when the osm tables are imported
+     *
+     * \param nodes [IN] the nodes of the routable ways, must outlive the document
+     */
+    void keep_nodes(const IdBitmap &nodes) {m_kept_nodes = &nodes;}
+
+    //! Is the node kept in the document?
+    bool keep_node(const Node &node) const;
+
+    /**
+     * The coordinates of the nodes go to the store,
+     * only the nodes with tags are kept in the document.
+     * The ways keep the node ids, resolve_nodes links them before exporting.
+     *
+     * \param store [IN] must outlive the document
+     */
+    void flat_nodes(FlatNodes &store) {m_flat_nodes = &store;}
+
+    /**
+     * finds the nodes of the way, read from the flat nodes store
+     *
+     * \param way [IN] a way of the document
+     * \param nodes [OUT] the nodes of the way, must outlive its use
+     * \param refs [OUT] pointers to the nodes, in the order of the way
+     */
+    void resolve_nodes(const Way &way, Nodes &nodes, std::vector<Node*> &refs) const;
+
     const Nodes& nodes() const {return m_nodes;}
     const Ways& ways() const {return m_ways;}
     const Relations& relations() const {return m_relations;}
 
-    void AddNode(const Node &n);
-    void AddWay(const Way &w);
+    void AddNode(Node n);
+    void AddWay(Way w);
     void AddRelation(const Relation &r);
     void endOfFile();
 
     //! find node by using an ID
     bool has_node(int64_t nodeRefId) const;
+    //! nullptr when the node is not on the document
     Node* FindNode(int64_t nodeRefId);
+    const NodeIndex& node_index() const {return *m_node_index;}
 
     bool has_way(int64_t way_id) const;
     Way* FindWay(int64_t way_id);
@@ -87,12 +120,25 @@ class OSMDocument {
 
     void add_node(Way &way, const char **atts);
 
+    /**
+     * links the way to the node when it is on the file
+     */
+    void link_node(Way &way, int64_t node_id);
+
     /**
      * add the configuration tag used for the speeds
      */
     void add_config(Element *osm_element, const Tag &tag) const;
+    void add_config(Node *node, const Tag &tag) const;
+
+    //! the nodes keep all their attributes for the osm_nodes table
+    bool node_attributes() const {
+        return m_vm.count("attributes") && m_vm.count("addnodes");
+    }
 
     inline uint16_t nodeErrs() const {return m_nodeErrs;}
+    //! nodes without lat or lon, skipped
+    size_t unlocated() const {return m_unlocated;}
 
  private:
     template <typename T>
@@ -102,45 +148,48 @@ class OSMDocument {
         }
 
 
-    void wait_child() const;
-
+    /**
+     * the last chunk of the container goes to the table,
+     * on a writer thread when there is one
+     */
     template <typename T>
         void
         osm_table_export(const T &osm_items, const std::string &table) const {
             if (osm_items.empty()) return;
 
-            if (m_vm.count("addnodes")) {
-#if 0
-                auto pid = fork();
-                if (pid < 0) {
-                    std::cerr << "Failed to fork" << endl;
-                    exit(1);
-                }
-                if (pid > 0) return;
-#endif
-            }
             auto residue = osm_items.size() % m_chunk_size;
             size_t start = residue? osm_items.size() - residue : osm_items.size() - m_chunk_size;
-            auto export_items = T(osm_items.begin() + start, osm_items.end());
-
-            m_db_conn.export_osm(export_items, table);
+            export_chunk(std::make_shared<T>(osm_items.begin() + start, osm_items.end()), table);
+        }
 
-            if (m_vm.count("addnodes")) {
-#if 0
-                /*
-                 * finish the child process
-                 */
-                _exit(0);
-#endif
+    /**
+     * the writer owns the copy of the chunk:
+     * the parser goes on filling the containers
+     */
+    template <typename T>
+        void
+        export_chunk(std::shared_ptr<T> export_items, const std::string &table) const {
+            if (!m_exports) {
+                m_db_conn.export_osm(*export_items, table);
+                return;
             }
+            const auto &db_conn = m_db_conn;
+            m_exports->push([&db_conn, export_items, table]() {
+                    db_conn.export_osm(*export_items, table);
+                    });
         }
 
+    //! waits for the writers and prints the time spent by each stage
+    void finish_exports();
+
    void export_pois() const;
 
 
  private:
-    // ! parsed nodes TODO change to sorted vector
+    // ! parsed nodes
     Nodes m_nodes;
+    //! position of the nodes in m_nodes
+    std::unique_ptr<NodeIndex> m_node_index;
     //! parsed ways
     Ways m_ways;
     //! parsed relations
@@ -151,10 +200,17 @@ class OSMDocument {
     const Configuration& m_rConfig;
     po::variables_map m_vm;
     const Export2DB &m_db_conn;
+    //! nodes kept, all of them when null
+    const IdBitmap *m_kept_nodes;
+    //! coordinates store, nodes are in memory when null
+    FlatNodes *m_flat_nodes;
 
     size_t m_chunk_size;
     uint16_t m_nodeErrs;
-    size_t m_lines;
+    size_t m_unlocated;
+
+    //! writer threads of the osm tables, null when the parser exports
+    std::unique_ptr<ExportQueue> m_exports;
 };
 
 }  // end namespace osm2pgr
@@ -60,6 +60,9 @@ class Relation : public Element{
      Relation() = delete;
      ~Relation() {};
      Relation(const Relation&) = default;
+     Relation(Relation&&) = default;
+     Relation& operator=(const Relation&) = default;
+     Relation& operator=(Relation&&) = default;
      std::vector<int64_t> way_refs() const {return m_WayRefs;}
      std::vector<int64_t>& way_refs() {return m_WayRefs;}
      std::string get_geometry() const {return std::string("");}
@@ -70,6 +73,7 @@ class Relation : public Element{
       */
      int64_t add_member(const char **atts);
      std::string members_str() const;
+     std::map<std::string, std::string> members() const;
 
      friend std::ostream& operator<<(std::ostream &os, const Relation &r);
 
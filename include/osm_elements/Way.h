@@ -54,6 +54,10 @@ namespace osm2pgr {
 class Way : public Element {
  public:
      Way() = default;
+     Way(const Way&) = default;
+     Way(Way&&) = default;
+     Way& operator=(const Way&) = default;
+     Way& operator=(Way&&) = default;
      ~Way() {};
 
      /**
@@ -65,10 +69,12 @@ class Way : public Element {
      void add_node(int64_t node_id);
 
      std::vector<Node*>& nodeRefs() {return m_NodeRefs;}
-     const std::vector<Node*> nodeRefs() const {return m_NodeRefs;}
+     const std::vector<int64_t>& node_ids() const {return m_node_ids;}
+     const std::vector<Node*>& nodeRefs() const {return m_NodeRefs;}
 
 
      std::string members_str() const;
+     std::map<std::string, std::string> members() const;
 
  public:
      inline void maxspeed_forward(double p_max) {m_maxspeed_forward = p_max;}
@@ -79,6 +85,8 @@ class Way : public Element {
 
      std::string oneWay() const;
      std::string oneWayType_str() const;
+     //! one_way column: 1 YES, 2 NO, 3 REVERSIBLE, -1 REVERSED, 0 UNKNOWN
+     int oneWayType() const;
      inline bool is_oneway() const { return m_oneWay == "YES";}
      inline bool is_reversed() const { return m_oneWay == "REVERSED";}
 
@@ -86,6 +94,7 @@ class Way : public Element {
      inline double maxspeed_backward() const { return m_maxspeed_backward;}
 
      std::string get_geometry() const;
+     void copy_geometry(CopyBuffer &row) const;
      std::string length_str() const;
 
 
@@ -99,8 +108,20 @@ class Way : public Element {
 
      //! splits the way
      std::vector<std::vector<Node*>> split_me();
+     /** @brief where the way is split
+      *
+      * Split i goes from nodeRefs[bounds[i]] to nodeRefs[bounds[i + 1]]:
+      * the bounds are the first node, the nodes used by other ways
+      * and the last node. Empty when there are less than 2 nodes.
+      */
+     static void split_bounds(
+             const std::vector<Node*> &nodeRefs,
+             std::vector<size_t> &bounds);
      std::string geometry_str(const std::vector<Node*> &) const;
      std::string length_str(const std::vector<Node*> &) const;
+     double length(const std::vector<Node*> &) const;
+     //! EWKB linestring of a split
+     void copy_geometry(const std::vector<Node*> &, CopyBuffer &row) const;
 
      /**
       * to insert the relations tags
@@ -30,6 +30,7 @@
 
 namespace osm2pgr {
 
+class CopyBuffer;
 
     /** @brief osm elements
 
@@ -47,11 +48,21 @@ class Element {
  public:
      Element() = default;
      Element(const Element&) = default;
+     Element(Element&&) = default;
+     Element& operator=(const Element&) = default;
+     Element& operator=(Element&&) = default;
      /**
       *    Constructor
       *    @param atts attributes pointer returned by the XML parser
       */
      explicit Element(const char **atts);
+     /**
+      *    Element without attributes
+      *    @param osm_id id of the element
+      */
+     explicit Element(int64_t osm_id) :
+         m_osm_id(osm_id),
+         m_visible(true) {}
      virtual ~Element() {};
 
      Tag add_tag(const Tag &);
@@ -71,7 +82,7 @@ class Element {
      bool has_attribute(const std::string&) const;
      std::string get_attribute(const std::string&) const;
      std::map<std::string, std::string>& attributes() {return m_attributes;}
-     const std::map<std::string, std::string> attributes() const {
+     const std::map<std::string, std::string>& attributes() const {
          return m_attributes;
      }
 
@@ -81,13 +92,27 @@ class Element {
 
      bool has_tags() const {return !m_tags.empty();}
      std::map<std::string, std::string>& tags() {return m_tags;}
-     const std::map<std::string, std::string> tags() const {return m_tags;}
+     const std::map<std::string, std::string>& tags() const {return m_tags;}
 
      std::vector<std::string> values(
              const std::vector<std::string> &columns,
              bool is_hstore) const;
      virtual std::string members_str() const {return std::string();};
 
+     /** @name binary COPY
+      * the same columns as values(), in the binary format
+      */
+     ///@{
+     void copy_values(
+             const std::vector<std::string> &columns,
+             CopyBuffer &row) const;
+     void copy_value(const std::string &column, CopyBuffer &row) const;
+     virtual void copy_geometry(CopyBuffer &row) const;
+     virtual std::map<std::string, std::string> members() const {
+         return std::map<std::string, std::string>();
+     }
+     ///@}
+
  protected:
      // ! OSM ID of the element
      // or id of a configuraton
@@ -52,6 +52,9 @@ class Tag {
  public:
      Tag() = default;
      Tag(const Tag&) = default;
+     Tag(Tag&&) = default;
+     Tag& operator=(const Tag&) = default;
+     Tag& operator=(Tag&&) = default;
      /**
       *    Constructor
       *    @param atts attributes pointer returned by the XML parser
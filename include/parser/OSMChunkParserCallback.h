@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef SRC_OSMCHUNKPARSERCALLBACK_H_
+#define SRC_OSMCHUNKPARSERCALLBACK_H_
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "./XMLParser.h"
+#include "osm_elements/OSMDocument.h"
+#include "utilities/progress.h"
+
+namespace osm2pgr {
+
+/**
+    Parser callback for one byte range of a parallel parse
+
+    Nodes and ways are built on the parsing thread, ways keep only
+    the identifiers of their nodes.
+    Relations modify the ways they reference, so their elements are
+    recorded and replayed after all the ways are in the document.
+*/
+class OSMChunkParserCallback :
+  public xml::XMLParserCallback {
+ public:
+    /**
+     *    Constructor
+     *
+     *    \param doc [IN] used only for the configuration
+     *    \param progress [OUT] when given, the parsed elements are counted there
+     */
+    explicit OSMChunkParserCallback(const OSMDocument& doc, ProgressCounters *progress = nullptr) :
+        m_rDocument(doc),
+        m_progress(progress),
+        m_current(NONE),
+        m_elements(0) {
+    }
+
+    /**
+     *    Moves the elements of the chunks into the document
+     *
+     *    - nodes, then ways, merged in id order
+     *    - the nodes of the ways are linked as the ways are added
+     *    - relations are replayed in file order
+     */
+    static void merge(
+            std::vector<std::unique_ptr<OSMChunkParserCallback>> &chunks,
+            OSMDocument &doc);
+
+ private:
+    virtual void StartElement(const char *name, const char** atts);
+
+    virtual void EndElement(const char* name);
+
+    void count_element();
+
+ private:
+    //! an element of a relation
+    struct Recorded {
+        bool start;
+        std::string name;
+        std::vector<std::string> atts;
+    };
+
+    enum Current {NONE, NODE, WAY, RELATION};
+
+    const OSMDocument& m_rDocument;
+    ProgressCounters *m_progress;
+    OSMDocument::Nodes m_nodes;
+    OSMDocument::Ways m_ways;
+    std::vector<Recorded> m_relations;
+    Current m_current;
+    uint64_t m_elements;
+};  // class OSMChunkParserCallback
+
+}  // end namespace osm2pgr
+
+#endif  // SRC_OSMCHUNKPARSERCALLBACK_H_
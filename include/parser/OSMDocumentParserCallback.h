@@ -29,7 +29,9 @@
 
 
 #include <string.h>
+#include <cstdint>
 #include "./XMLParser.h"
+#include "utilities/progress.h"
 
 namespace osm2pgr {
 
@@ -56,24 +58,35 @@ class OSMDocumentParserCallback :
  public:
     /**
      *    Constructor
+     *
+     *    \param progress [OUT] when given, the parsed elements are counted there
      */
-    explicit OSMDocumentParserCallback(OSMDocument& doc) :
+    explicit OSMDocumentParserCallback(OSMDocument& doc, ProgressCounters *progress = nullptr) :
         m_rDocument(doc),
         m_pActRelation(0),
         last_node(nullptr),
         last_way(nullptr),
         last_relation(nullptr),
-        m_line(0),
+        m_progress(progress),
+        m_elements(0),
         m_section(1) {
     }
+
+    /**
+     *    The next elements are relations:
+     *    used to replay the relations of a parallel parse
+     */
+    void relations_section() {m_section = 3;}
+
  private:
-    void show_progress();
+    void count_element();
 
  private:
     Node *last_node;
     Way *last_way;
     Relation* last_relation;
-    size_t m_line;
+    ProgressCounters *m_progress;
+    uint64_t m_elements;
     int m_section;
 };  // class OSMDocumentParserCallback
 
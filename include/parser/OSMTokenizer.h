@@ -0,0 +1,139 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef SRC_OSMTOKENIZER_H_
+#define SRC_OSMTOKENIZER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./XMLParser.h"
+
+
+namespace xml {
+
+/**
+  Tokenizer for the subset of XML written by the OSM tools
+
+  Accepted:
+  - an optional <?xml ...?> declaration, UTF-8 encoded
+  - elements with single or double quoted attributes
+  - the predefined entities and the character references in attribute values
+  - white space between the elements
+
+  Anything else (comments, CDATA, DOCTYPE, text, ...) is rejected and
+  the parsing has to be resumed with expat where the tokenizer stopped.
+  An element below the root is parsed completely, children included,
+  before its events are delivered, so expat can resume at its start
+  without delivering an event twice.
+
+  Attribute values are scanned 16 bytes at a time (SSE2) for the
+  quote, '&', '<', control and non ASCII bytes; entities are only
+  decoded when one was found.
+*/
+class OSMTokenizer {
+ public:
+    enum Status {
+        //! everything was parsed
+        DONE,
+        //! stopped at offset(), to be resumed with expat
+        REJECTED,
+        //! the input is not well formed, see error()
+        FAILED
+    };
+
+    /**
+      \param callback [IN] receives the events
+      \param bytes_read [OUT] when given, bytes parsed so far
+     */
+    explicit OSMTokenizer(
+            XMLParserCallback &callback,
+            std::atomic<uint64_t> *bytes_read = nullptr);
+
+    /**
+      Parses a whole document
+
+      When REJECTED with offset() > 0 the root element is open:
+      expat has to parse the rest as the content of root().
+     */
+    Status ParseDocument(const char *data, size_t size);
+
+    /**
+      Parses the content of the root element (a range of a parallel parse)
+     */
+    Status ParseContent(const char *data, size_t size);
+
+    //! where the tokenizer stopped
+    size_t offset() const {return m_offset;}
+    //! name of the root element
+    const std::string& root() const {return m_root;}
+    const std::string& error() const {return m_error;}
+
+ private:
+    struct Event {
+        size_t name;
+        size_t first_att;
+        size_t atts;
+        bool start;
+    };
+
+    Status content(bool document);
+    Status epilogue();
+    bool prolog();
+    bool element();
+    bool start_tag(bool &empty);
+    bool end_tag(size_t name);
+    bool name();
+    bool attribute_value();
+    bool entity();
+    void skip_space();
+    void replay();
+    void report(const char *position, bool last);
+    Status reject(const char *where);
+
+ private:
+    XMLParserCallback &m_callback;
+    std::atomic<uint64_t> *m_bytes_read;
+    bool m_absolute;
+    size_t m_reported;
+
+    const char *m_data;
+    const char *m_p;
+    const char *m_end;
+    size_t m_offset;
+    std::string m_root;
+    std::string m_error;
+
+    //! names and values, nul terminated
+    std::string m_text;
+    //! offsets of the attribute names and values in m_text
+    std::vector<size_t> m_atts;
+    std::vector<Event> m_events;
+    //! elements still open, offsets in m_text
+    std::vector<size_t> m_open;
+    std::vector<const char*> m_pointers;
+};
+
+}  // end namespace xml
+#endif  //  SRC_OSMTOKENIZER_H_
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_PBFPARSER_H_
+#define SRC_PBFPARSER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "./XMLParser.h"
+
+
+namespace xml {
+
+/**
+  Parser for the OSM PBF (protocol buffer binary) format
+
+  The file is read sequentially, every OSMData blob is inflated and
+  decoded on a pool of threads, and the decoded elements are handed
+  to the XMLParserCallback in file order.
+
+  The callback receives the same events it gets from an .osm file:
+  - osm, node, tag, way, nd, relation, member start / end elements
+  - attributes as strings, formatted like the XML writers do
+
+  Dependencies:
+  - zlib
+*/
+class PBFParser {
+ public:
+    /**
+      \param threads [IN] decoding threads, 0 means one per hardware thread
+     */
+    explicit PBFParser(size_t threads = 0) :
+        m_threads(threads) {}
+    //! Destructor
+    virtual ~PBFParser() {}
+
+  /**
+    Parse a file from the file system
+
+    \param rCallback [IN] the parser callback
+    \param chFileName [IN] name of the file to be parsed
+    \param bytes_read [OUT] when given, bytes of the file parsed so far
+
+    \return 0: everything ok, 1: file not found, 2: parsing error
+   */
+    int Parse(
+            XMLParserCallback& rCallback,
+            const char* chFileName,
+            std::atomic<uint64_t> *bytes_read = nullptr);
+
+ private:
+    //! number of decoding threads
+    size_t m_threads;
+};
+
+}  // end namespace xml
+#endif  //  SRC_PBFPARSER_H_
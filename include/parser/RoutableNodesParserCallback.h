@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef SRC_ROUTABLENODESPARSERCALLBACK_H_
+#define SRC_ROUTABLENODESPARSERCALLBACK_H_
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "./XMLParser.h"
+#include "configuration/configuration.h"
+#include "utilities/id_bitmap.h"
+#include "utilities/progress.h"
+
+namespace osm2pgr {
+
+/**
+    Parser callback of the first pass of a two pass import
+
+    Records the nodes of the routable ways: the ways with a tag of the
+    configuration and the ways of the relations with a tag of the
+    configuration.
+
+    Relations follow the ways on the file, when they make routable a
+    way that was not, promoted() is not empty and the file has to be
+    parsed once more in promoted_pass() mode to record its nodes.
+*/
+class RoutableNodesParserCallback :
+  public xml::XMLParserCallback {
+ public:
+    /**
+     *    Constructor
+     *
+     *    \param config [IN] the tags that make a way routable
+     *    \param nodes [OUT] the nodes of the routable ways
+     *    \param progress [OUT] when given, the parsed elements are counted there
+     */
+    RoutableNodesParserCallback(
+            const Configuration &config,
+            IdBitmap &nodes,
+            ProgressCounters *progress = nullptr) :
+        m_rConfig(config),
+        m_nodes(nodes),
+        m_progress(progress),
+        m_promoted_pass(false),
+        m_current(NONE),
+        m_routable(false),
+        m_id(0),
+        m_elements(0) {
+    }
+
+    //! ways made routable by a relation
+    const IdBitmap& promoted() const {return m_promoted;}
+
+    //! the next parse records only the nodes of the promoted ways
+    void promoted_pass() {m_promoted_pass = true;}
+
+ private:
+    virtual void StartElement(const char *name, const char** atts);
+
+    virtual void EndElement(const char* name);
+
+    void count_element();
+
+ private:
+    enum Current {NONE, WAY, RELATION};
+
+    const Configuration &m_rConfig;
+    IdBitmap &m_nodes;
+    ProgressCounters *m_progress;
+    //! the ways routable by their own tags
+    IdBitmap m_ways;
+    IdBitmap m_promoted;
+    bool m_promoted_pass;
+
+    Current m_current;
+    bool m_routable;
+    int64_t m_id;
+    //! nodes of the current way or ways of the current relation
+    std::vector<int64_t> m_refs;
+    uint64_t m_elements;
+};  // class RoutableNodesParserCallback
+
+}  // end namespace osm2pgr
+
+#endif  // SRC_ROUTABLENODESPARSERCALLBACK_H_
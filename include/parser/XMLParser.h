@@ -23,6 +23,9 @@
 #define SRC_XMLPARSER_H_
 
 #include <expat.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 
 namespace xml {
@@ -57,6 +60,13 @@ class XMLParserCallback {
   James Clark http://www.jclark.com/xml/expat.html.
   
   Fast, event driven, non-validating parser
+
+  Regular files are memory mapped and handed to expat in large windows,
+  pipes and the standard input are read by a reader thread with double
+  buffering.
+
+  Uncompressed regular files can be parsed with the OSMTokenizer
+  instead, expat resumes where the tokenizer stops.
   
   Dependencies:
   - link with xmlparse.lib
@@ -64,8 +74,13 @@ class XMLParserCallback {
 */
 class XMLParser {
  public:
-  //! Constructor
-    XMLParser() {}
+  /**
+    Constructor
+
+    \param tokenizer [IN] use the OSMTokenizer on uncompressed regular files
+   */
+    explicit XMLParser(bool tokenizer = false) :
+        m_tokenizer(tokenizer) {}
     //! Destructor
     virtual ~XMLParser() {}
 
@@ -73,15 +88,45 @@ class XMLParser {
     Parse a file from the file system-
     
     \param rCallback [IN] the parser callback
-    \param chFileName [IN] name of the file to be parsed  
+    \param chFileName [IN] name of the file to be parsed, "-" for the standard input
+    \param bytes_read [OUT] when given, bytes of the file parsed so far,
+           updated as the parsing advances for a progress reporter
     
     \return 0: everything ok, 1: file not found, 2: parsing error
    */  
-    int Parse(XMLParserCallback& rCallback, const char* chFileName);
+    int Parse(
+            XMLParserCallback& rCallback,
+            const char* chFileName,
+            std::atomic<uint64_t> *bytes_read = nullptr);
+
+  /**
+    Parse an uncompressed file on several threads
+
+    The file is cut in as many byte ranges as callbacks, every range
+    starts on a <node, <way or <relation element, out of the comments,
+    CDATA sections and processing instructions.
+    Each range is parsed on its own thread, as the content of an
+    "osm" element, by its own callback. The parsing errors of a range
+    are not printed: the file can be parsed again by Parse().
+
+    \param callbacks [IN] one callback per range, in file order
+    \param chFileName [IN] name of the file to be parsed
+    \param bytes_read [OUT] when given, bytes of the file parsed so far
+
+    \return 0: everything ok, 1: file not found, 2: parsing error,
+            3: the file can not be split (compressed, not a regular file
+            or its root element is not osm)
+   */
+    int ParseParallel(
+            const std::vector<XMLParserCallback*> &callbacks,
+            const char* chFileName,
+            std::atomic<uint64_t> *bytes_read = nullptr);
 
  private:
     //! the expat parser object / imported from „expat.h“
     XML_Parser            m_ParserCtxt;
+    //! the OSMTokenizer is tried first
+    bool m_tokenizer;
 };
 
 }  // end namespace xml
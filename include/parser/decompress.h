@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#ifndef SRC_DECOMPRESS_H_
+#define SRC_DECOMPRESS_H_
+
+#include <cstddef>
+#include "utilities/buffer_queue.h"
+
+
+namespace xml {
+
+/**
+  Compression formats recognized on the input
+ */
+enum Compression {NONE, GZIP, BZIP2, ZSTD};
+
+/**
+  Detects the compression by the magic bytes at the start of the input
+
+  \param data [IN] the first bytes of the input
+  \param len [IN] how many bytes are available (4 are enough)
+ */
+Compression detect_compression(const char *data, size_t len);
+
+const char* compression_name(Compression compression);
+
+/**
+  Producer for inputs held in memory (mapped files)
+
+  Multi-stream bzip2 and multi-frame zstd inputs, as written by the
+  parallel compressors, are decompressed on a pool of threads and
+  pushed in order to the queue, otherwise the input is decompressed
+  sequentially.
+
+  Errors are reported to the consumer through the queue.
+ */
+void decompress_mapped(
+        Compression compression,
+        const char *data, size_t size,
+        osm2pgr::BufferQueue &queue);
+
+/**
+  Producer for inputs that can only be read sequentially (pipes, stdin)
+
+  \param head [IN] bytes already read from the file descriptor
+ */
+void decompress_stream(
+        Compression compression,
+        int fd,
+        const char *head, size_t head_len,
+        osm2pgr::BufferQueue &queue);
+
+}  // end namespace xml
+#endif  //  SRC_DECOMPRESS_H_
@@ -0,0 +1,100 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+/** @file **/
+
+#ifndef SRC_BUFFER_QUEUE_H_
+#define SRC_BUFFER_QUEUE_H_
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace osm2pgr {
+
+/** @brief block of raw input handed from a producer thread to the parser */
+struct Buffer {
+    Buffer() : size(0), capacity(0), input_offset(0) {}
+    explicit Buffer(size_t p_capacity) :
+        data(new char[p_capacity]),
+        size(0),
+        capacity(p_capacity),
+        input_offset(0) {}
+
+    std::unique_ptr<char[]> data;
+    //! bytes used
+    size_t size;
+    //! bytes allocated
+    size_t capacity;
+    //! bytes of the input file consumed once this buffer is parsed
+    uint64_t input_offset;
+};
+
+
+/** @brief bounded queue of recycled buffers between one producer and one consumer
+ *
+ * The queue owns a fixed number of buffers, so the producer blocks
+ * (back-pressure) when the consumer is behind:
+ * - two buffers: double buffering
+ * - more buffers: room to absorb the consumer's pauses
+ *
+ * A filled buffer with size 0 marks the end of the input.
+ */
+class BufferQueue {
+ public:
+     BufferQueue(size_t buffers, size_t buffer_size);
+
+     /* producer side */
+
+     /** waits for an empty buffer
+      * @returns false when the consumer closed the queue
+      */
+     bool acquire(Buffer &buffer);
+     void push(Buffer buffer);
+     /** stops the consumer with an error message */
+     void fail(const std::string &message);
+
+     /* consumer side */
+
+     /** waits for a filled buffer
+      * @returns false at the end of the input
+      * @throws std::runtime_error when the producer failed
+      */
+     bool pop(Buffer &buffer);
+     void release(Buffer buffer);
+     /** stops the producer */
+     void close();
+
+ private:
+     std::mutex m_mutex;
+     std::condition_variable m_cv;
+     std::deque<Buffer> m_empty;
+     std::deque<Buffer> m_filled;
+     std::string m_error;
+     bool m_closed;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_BUFFER_QUEUE_H_
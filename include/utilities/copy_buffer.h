@@ -0,0 +1,125 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+/** @file **/
+
+#ifndef SRC_COPY_BUFFER_H_
+#define SRC_COPY_BUFFER_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace osm2pgr {
+
+/** @brief rows of a COPY ... FROM STDIN
+ *
+ * The fields are appended, typed, to a buffer that keeps its memory
+ * after clear(): once it has grown, writing a row does not allocate.
+ *
+ * Binary format (the default): each field is its length (int32, -1
+ * for NULL) followed by the binary representation of the column type,
+ * in network byte order. Geometries are sent as EWKB with SRID 4326.
+ *
+ * Text format: tab separated fields, escaped for COPY, geometries as
+ * EWKT.
+ *
+ * Like tab_separated(), empty strings and empty hstores are NULL.
+ */
+class CopyBuffer {
+ public:
+     //! @param binary binary or text format
+     explicit CopyBuffer(bool binary = true) :
+         m_binary(binary),
+         m_fields(0),
+         m_points(0) {}
+
+     bool binary() const {return m_binary;}
+
+     //! PGCOPY signature, flags and header extension (binary only)
+     void header();
+     //! end of data marker (binary only)
+     void trailer();
+
+     //! starts a row of @b fields fields
+     void row(size_t fields);
+
+     void null();
+     void boolean(bool value);
+     void int4(int32_t value);
+     void int8(int64_t value);
+     void float8(double value);
+     //! a float8 column from 1e-7 degrees
+     void degrees(int32_t value);
+     //! a numeric column from 1e-7 degrees
+     void numeric(int32_t value);
+     void text(const std::string &value);
+     void hstore(const std::map<std::string, std::string> &values);
+
+     /** @name geometries
+      * coordinates in 1e-7 degrees
+      */
+     ///@{
+     void point(int32_t lon, int32_t lat);
+     //! a linestring of @b points coordinates, added with coordinate()
+     void linestring(size_t points);
+     void coordinate(int32_t lon, int32_t lat);
+     ///@}
+
+     const char* data() const {return m_data.data();}
+     size_t size() const {return m_data.size();}
+     bool empty() const {return m_data.empty();}
+     void clear() {m_data.clear();}
+     void reserve(size_t bytes) {m_data.reserve(bytes);}
+
+     //! moves the rows out
+     std::string release();
+     //! rows released by another buffer
+     void append(const std::string &rows) {m_data.append(rows);}
+     //! rows written by another buffer of the same format
+     void append(const CopyBuffer &rows) {m_data.append(rows.m_data);}
+
+ private:
+     void put16(uint16_t value);
+     void put32(uint32_t value);
+     void put64(uint64_t value);
+     void ewkb(uint32_t type);
+
+     //! text format: the separator after the field
+     void end_field();
+     void decimal(int64_t value);
+     void fixed(int32_t value);
+     void escaped(const char *text, size_t size);
+     void hstore_quoted(const std::string &text);
+
+ private:
+     bool m_binary;
+     //! text format: fields left on the row
+     size_t m_fields;
+     //! text format: coordinates left on the linestring
+     size_t m_points;
+     std::string m_data;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_COPY_BUFFER_H_
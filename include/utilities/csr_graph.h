@@ -0,0 +1,134 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+/** @file **/
+
+#ifndef SRC_CSR_GRAPH_H_
+#define SRC_CSR_GRAPH_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief the routing graph as a compressed sparse row file
+ *
+ * Layout (version 1, byte order of the writer, checked by byte_order):
+ * a Header of 128 bytes, then the arrays it points to, each starting
+ * on a multiple of 64 bytes, so the file can be mapped and used as is.
+ *
+ * - offsets   uint64_t[vertices + 1]: the arcs of vertex v are [offsets[v], offsets[v + 1])
+ * - targets   uint32_t[arcs]: index of the vertex the arc goes to
+ * - costs     double[arcs]: cost of the arc, negative when it can not be used
+ * - reverse_costs double[arcs]: cost from the target back to the vertex
+ * - arc_edges uint32_t[arcs]: index of the edge of the arc
+ * - vertex_ids int64_t[vertices]: id of the vertex on ways_vertices_pgr
+ * - lon, lat  double[vertices]: coordinates of the vertices
+ * - gids      int64_t[edges]: gid of the edge on ways
+ *
+ * Each edge gives two arcs: one from its source (cost, reverse_cost)
+ * and one from its target (reverse_cost, cost), the row of a vertex
+ * holds all its edges. The vertices are in the order of their ids.
+ */
+class CsrGraph {
+ public:
+     struct Header {
+         char magic[8];
+         uint32_t version;
+         uint32_t byte_order;
+         uint64_t vertices;
+         uint64_t edges;
+         uint64_t arcs;
+         //! byte offsets of the arrays on the file
+         uint64_t offsets;
+         uint64_t targets;
+         uint64_t costs;
+         uint64_t reverse_costs;
+         uint64_t arc_edges;
+         uint64_t vertex_ids;
+         uint64_t lon;
+         uint64_t lat;
+         uint64_t gids;
+         uint64_t file_size;
+         uint64_t reserved;
+     };
+
+     //! a row of the ways table
+     struct Edge {
+         int64_t gid;
+         int64_t source;
+         int64_t target;
+         double cost;
+         double reverse_cost;
+         int32_t source_lon;
+         int32_t source_lat;
+         int32_t target_lon;
+         int32_t target_lat;
+     };
+
+     static const uint32_t version = 1;
+
+     /** @brief writes the graph of the edges
+      *
+      * The file is written next to file_name and renamed at the end:
+      * a program mapping the old file keeps a complete graph.
+      *
+      * @throws std::runtime_error when the file can not be written
+      *   or the graph does not fit the 32 bit indexes
+      */
+     static Header write(const std::string &file_name, const std::vector<Edge> &edges);
+};
+
+
+/** @brief a graph file written by CsrGraph, mapped read only */
+class CsrFile {
+ public:
+     /** @throws std::runtime_error when the file can not be mapped or is not a valid graph */
+     explicit CsrFile(const std::string &file_name);
+     ~CsrFile();
+
+     CsrFile(const CsrFile&) = delete;
+     CsrFile& operator=(const CsrFile&) = delete;
+
+     const CsrGraph::Header& header() const {return *reinterpret_cast<const CsrGraph::Header*>(m_map);}
+
+     const uint64_t* offsets() const {return array<uint64_t>(header().offsets);}
+     const uint32_t* targets() const {return array<uint32_t>(header().targets);}
+     const double* costs() const {return array<double>(header().costs);}
+     const double* reverse_costs() const {return array<double>(header().reverse_costs);}
+     const uint32_t* arc_edges() const {return array<uint32_t>(header().arc_edges);}
+     const int64_t* vertex_ids() const {return array<int64_t>(header().vertex_ids);}
+     const double* lon() const {return array<double>(header().lon);}
+     const double* lat() const {return array<double>(header().lat);}
+     const int64_t* gids() const {return array<int64_t>(header().gids);}
+
+ private:
+     template <typename T>
+     const T* array(uint64_t offset) const {return reinterpret_cast<const T*>(m_map + offset);}
+
+     const char *m_map;
+     size_t m_size;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_CSR_GRAPH_H_
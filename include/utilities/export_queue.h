@@ -0,0 +1,105 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+/** @file **/
+
+#ifndef SRC_EXPORT_QUEUE_H_
+#define SRC_EXPORT_QUEUE_H_
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief bounded queue of export tasks run by writer threads
+ *
+ * The parser pushes each finished chunk (a task owning its copy of
+ * the elements) and goes on parsing while a writer sends it to the
+ * database on its own session. When `capacity` tasks are waiting,
+ * push() blocks: back-pressure keeps the memory of the pending chunks
+ * bounded when the database is slower than the parser.
+ *
+ * The time the parser spent blocked and the time the writers spent
+ * exporting tell which stage is the bottleneck.
+ */
+class ExportQueue {
+ public:
+     typedef std::function<void()> Task;
+
+     /**
+      * @param writers number of writer threads, started on the first push
+      * @param capacity tasks waiting before push() blocks
+      */
+     ExportQueue(size_t writers, size_t capacity);
+
+     /** runs the queued tasks and joins the writers */
+     ~ExportQueue();
+
+     ExportQueue(const ExportQueue&) = delete;
+     ExportQueue& operator=(const ExportQueue&) = delete;
+
+     //! waits while the queue is full
+     void push(Task task);
+
+     //! waits for the queued tasks to be done, the writers are joined
+     void finish();
+
+     /** @name stage timings, once finished */
+     ///@{
+     //! tasks done
+     size_t tasks() const {return m_tasks;}
+     //! seconds the producer was blocked on a full queue
+     double producer_wait() const {return m_producer_wait.count();}
+     //! seconds spent running the tasks, all writers added
+     double writers_busy() const {return m_writers_busy.count();}
+     //! seconds from the first push to the end of finish()
+     double elapsed() const {return m_elapsed.count();}
+     size_t writers() const {return m_writers;}
+     ///@}
+
+ private:
+     void work();
+
+ private:
+     size_t m_writers;
+     size_t m_capacity;
+     std::vector<std::thread> m_threads;
+     std::deque<Task> m_queue;
+     std::mutex m_mutex;
+     std::condition_variable m_not_empty;
+     std::condition_variable m_not_full;
+     bool m_done;
+
+     size_t m_tasks;
+     std::chrono::steady_clock::time_point m_start;
+     std::chrono::duration<double> m_producer_wait;
+     std::chrono::duration<double> m_writers_busy;
+     std::chrono::duration<double> m_elapsed;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_EXPORT_QUEUE_H_
@@ -0,0 +1,99 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+/** @file **/
+
+#ifndef SRC_FLAT_NODES_H_
+#define SRC_FLAT_NODES_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace osm2pgr {
+
+/** @brief node coordinates on a memory mapped file indexed by node id
+ *
+ * One slot of 8 bytes (lat, lon in 1e-7 degrees) per node id after a
+ * header page. The file is sparse: the holes of the id range use no
+ * disk, and the page cache decides what stays in memory.
+ *
+ * The header records the size and modification time of the input;
+ * once complete() is called, a later run on the same input reuses the
+ * file and does not write it again. Any other file is emptied first:
+ * the nodes of another input are not read back.
+ *
+ * The number of ways using each node is counted here too, in an
+ * anonymous mapping of one byte per id (saturated at 255).
+ *
+ * Negative ids (JOSM files) are kept in memory: they are set on every
+ * run, even when the file is reused.
+ */
+class FlatNodes {
+ public:
+     /**
+      * @param file_name the flat nodes file, created when missing
+      * @param input_size, input_mtime identify the input
+      * @throws std::runtime_error when the file can not be opened or mapped
+      */
+     FlatNodes(const std::string &file_name, uint64_t input_size, int64_t input_mtime);
+     ~FlatNodes();
+
+     FlatNodes(const FlatNodes&) = delete;
+     FlatNodes& operator=(const FlatNodes&) = delete;
+
+     //! the file already holds the nodes of the input
+     bool reused() const {return m_reused;}
+
+     void set(int64_t id, int32_t lat, int32_t lon);
+     /** @returns false when the node is not on the file */
+     bool get(int64_t id, int32_t &lat, int32_t &lon) const;
+
+     //! all the nodes of the input are on the file
+     void complete();
+
+     void add_use(int64_t id);
+     uint16_t uses(int64_t id) const;
+
+ private:
+     struct Header;
+
+     void grow_file(uint64_t slots);
+     void grow_uses(uint64_t ids);
+
+     std::string m_file_name;
+     int m_fd;
+     char *m_map;
+     //! node slots on the file
+     uint64_t m_slots;
+     bool m_reused;
+
+     unsigned char *m_uses;
+     uint64_t m_uses_capacity;
+
+     std::unordered_map<int64_t, std::pair<int32_t, int32_t>> m_negative;
+     std::unordered_map<int64_t, uint16_t> m_negative_uses;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_FLAT_NODES_H_
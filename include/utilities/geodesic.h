@@ -0,0 +1,64 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+#ifndef SRC_GEODESIC_H_
+#define SRC_GEODESIC_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace osm2pgr {
+
+/** @brief lengths in meters on the WGS84 ellipsoid
+ *
+ * What ST_Length(geography) gives, computed while the rows are written.
+ *
+ * The coordinates are in 1e-7 degrees, as stored by the nodes.
+ * Short segments (the usual OSM segment) use the local flat ellipsoid
+ * at their mid latitude: no iteration, one sin and cos per segment,
+ * within a millimeter of the geodesic up to geodesic_flat_limit.
+ * Longer segments use Vincenty's inverse formula.
+ */
+
+//! longest |dlon| + |dlat|, in 1e-7 degrees, of a segment measured flat
+constexpr int64_t geodesic_flat_limit = 500000;
+
+/** @brief length of the polyline
+ *
+ * @param[in] lon, lat the n points
+ * @returns meters
+ */
+double geodesic_length(const int32_t *lon, const int32_t *lat, size_t n);
+
+//! meters between two points in 1e-7 degrees
+double geodesic_distance(int32_t lon1, int32_t lat1, int32_t lon2, int32_t lat2);
+
+/** @brief Vincenty's inverse formula
+ *
+ * @param[in] lon1, lat1, lon2, lat2 degrees
+ * @returns meters, the spherical distance for nearly antipodal points
+ *          where the iteration does not converge
+ */
+double vincenty_distance(double lon1, double lat1, double lon2, double lat2);
+
+}  // namespace osm2pgr
+
+#endif  // SRC_GEODESIC_H_
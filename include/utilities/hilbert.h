@@ -0,0 +1,44 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+
+#ifndef SRC_HILBERT_H_
+#define SRC_HILBERT_H_
+#pragma once
+
+#include <cstdint>
+
+namespace osm2pgr {
+
+/** @brief position of a point along a Hilbert curve covering the world
+ *
+ * The coordinates are in 1e-7 degrees, as stored by the nodes, shifted
+ * to unsigned values, the latitude doubled to keep the cells square:
+ * the curve has 2^32 x 2^32 cells, a cell is not larger than the
+ * precision of the coordinates.
+ *
+ * Points close on the curve are close on the map: rows written in the
+ * order of their keys keep neighbours on the same pages of the tables.
+ */
+uint64_t hilbert_key(int32_t lon, int32_t lat);
+
+}  // namespace osm2pgr
+
+#endif  // SRC_HILBERT_H_
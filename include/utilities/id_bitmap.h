@@ -0,0 +1,91 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+/** @file **/
+
+#ifndef SRC_ID_BITMAP_H_
+#define SRC_ID_BITMAP_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief set of OSM ids, one bit per id
+ *
+ * The bits are kept in pages of 2^16 ids allocated on the first id
+ * set in them, the osm ids are dense so the pages fill up:
+ * about 1 bit per id of the file's id range, independently of the
+ * number of ids set.
+ *
+ * Negative ids (new objects in JOSM files) are kept apart.
+ *
+ * Concurrent calls to has() are safe once no id is added.
+ */
+class IdBitmap {
+ public:
+     IdBitmap() : m_count(0) {}
+
+     void set(int64_t id) {
+         if (id < 0) {
+             if (m_negative.insert(id).second) ++m_count;
+             return;
+         }
+         auto page = static_cast<uint64_t>(id) >> page_bits;
+         if (page >= m_pages.size()) m_pages.resize(page + 1);
+         if (!m_pages[page]) m_pages[page].reset(new uint64_t[page_words]());
+         auto &word = m_pages[page][(static_cast<uint64_t>(id) & page_mask) >> 6];
+         auto bit = uint64_t(1) << (id & 63);
+         if (!(word & bit)) {
+             word |= bit;
+             ++m_count;
+         }
+     }
+
+     bool has(int64_t id) const {
+         if (id < 0) return m_negative.count(id) != 0;
+         auto page = static_cast<uint64_t>(id) >> page_bits;
+         if (page >= m_pages.size() || !m_pages[page]) return false;
+         return (m_pages[page][(static_cast<uint64_t>(id) & page_mask) >> 6] >> (id & 63)) & 1;
+     }
+
+     //! number of ids set
+     size_t size() const {return m_count;}
+     bool empty() const {return m_count == 0;}
+
+     //! bytes used by the pages
+     size_t memory() const;
+
+ private:
+     static const unsigned page_bits = 16;
+     static const uint64_t page_mask = (uint64_t(1) << page_bits) - 1;
+     static const size_t page_words = (size_t(1) << page_bits) / 64;
+
+     std::vector<std::unique_ptr<uint64_t[]>> m_pages;
+     std::unordered_set<int64_t> m_negative;
+     size_t m_count;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_ID_BITMAP_H_
@@ -0,0 +1,143 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+/** @file **/
+
+#ifndef SRC_NODE_INDEX_H_
+#define SRC_NODE_INDEX_H_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief position of a node in the document's node vector, by node id
+ *
+ * Implementations:
+ * - sorted: the ids in a compact array, binary search (default)
+ * - dense: an array indexed by the id, mapped without reserving memory,
+ *   only the pages of the ids on the file are used: for the planet
+ * - sparse: a hash table, for small extracts
+ */
+class NodeIndex {
+ public:
+     //! returned by find() when the id is not indexed
+     static const size_t npos;
+
+     virtual ~NodeIndex() {}
+
+     /** the node @b id is at @b position */
+     virtual void add(int64_t id, size_t position) = 0;
+
+     /** @brief the nodes added so far are all there: prepares find()
+      *
+      * Called by the parsing thread once the nodes are added: find()
+      * does not modify the index and can be called from several threads.
+      */
+     virtual void finish() {}
+
+     /** @returns the position of the node, npos when not indexed */
+     virtual size_t find(int64_t id) const = 0;
+
+     virtual size_t size() const = 0;
+
+     //! bytes used by the index
+     virtual size_t memory() const = 0;
+
+     /** @brief creates an index
+      * @param type sorted, dense or sparse
+      * @throws std::invalid_argument on an unknown type
+      */
+     static std::unique_ptr<NodeIndex> create(const std::string &type);
+};
+
+
+/** @brief ids in one array (structure of arrays), binary search
+ *
+ * The files are sorted by id, so the positions are implicit;
+ * when an id comes out of order the positions are kept too and both
+ * arrays are sorted by finish(). Until then find() reads the ids one
+ * after the other.
+ */
+class SortedNodeIndex : public NodeIndex {
+ public:
+     SortedNodeIndex() : m_sorted(true) {}
+
+     void add(int64_t id, size_t position);
+     void finish();
+     size_t find(int64_t id) const;
+     size_t size() const {return m_ids.size();}
+     size_t memory() const;
+
+ private:
+     std::vector<int64_t> m_ids;
+     //! empty while the ids are added in order
+     std::vector<size_t> m_positions;
+     bool m_sorted;
+};
+
+
+/** @brief array indexed by id, anonymous mapping grown on demand
+ *
+ * Holds position + 1, 0 is a missing node.
+ * Negative ids (JOSM files) go to a hash table.
+ */
+class DenseNodeIndex : public NodeIndex {
+ public:
+     DenseNodeIndex() : m_slots(nullptr), m_capacity(0), m_size(0) {}
+     ~DenseNodeIndex();
+
+     DenseNodeIndex(const DenseNodeIndex&) = delete;
+     DenseNodeIndex& operator=(const DenseNodeIndex&) = delete;
+
+     void add(int64_t id, size_t position);
+     size_t find(int64_t id) const;
+     size_t size() const {return m_size;}
+     size_t memory() const;
+
+ private:
+     void reserve(uint64_t slots);
+
+     uint32_t *m_slots;
+     uint64_t m_capacity;
+     size_t m_size;
+     std::unordered_map<int64_t, size_t> m_negative;
+};
+
+
+/** @brief hash table */
+class SparseNodeIndex : public NodeIndex {
+ public:
+     void add(int64_t id, size_t position) {m_positions[id] = position;}
+     size_t find(int64_t id) const;
+     size_t size() const {return m_positions.size();}
+     size_t memory() const;
+
+ private:
+     std::unordered_map<int64_t, size_t> m_positions;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_NODE_INDEX_H_
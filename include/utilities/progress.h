@@ -0,0 +1,95 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+/** @file **/
+
+#ifndef SRC_PROGRESS_H_
+#define SRC_PROGRESS_H_
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace osm2pgr {
+
+/** @brief counters written by the parsing thread
+ *
+ * The parser only stores into the atomics, the reporter thread reads them.
+ */
+struct ProgressCounters {
+    ProgressCounters() : bytes(0), elements(0) {}
+
+    //! bytes of the input file consumed
+    std::atomic<uint64_t> bytes;
+    //! nodes, ways and relations parsed
+    std::atomic<uint64_t> elements;
+};
+
+
+/** @brief prints the parsing progress from its own thread
+ *
+ * Once per interval: percentage of the input, MB/s, elements/s and
+ * the estimated time left.
+ * When the size of the input is not known (pipes) only the throughput
+ * is printed.
+ */
+class ProgressReporter {
+ public:
+     /**
+      * @param counters  updated by the parser
+      * @param total_bytes size of the input, 0 when unknown
+      * @param interval  time between two reports
+      */
+     ProgressReporter(
+             const ProgressCounters &counters,
+             uint64_t total_bytes,
+             std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+     /** stops the reporter */
+     ~ProgressReporter();
+
+     ProgressReporter(const ProgressReporter&) = delete;
+     ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+     /** prints the last report and joins the thread */
+     void stop();
+
+ private:
+     void run();
+     void report() const;
+
+ private:
+     const ProgressCounters &m_counters;
+     uint64_t m_total_bytes;
+     std::chrono::milliseconds m_interval;
+     std::chrono::steady_clock::time_point m_start;
+     std::mutex m_mutex;
+     std::condition_variable m_cv;
+     bool m_stop;
+     std::thread m_thread;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_PROGRESS_H_
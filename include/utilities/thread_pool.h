@@ -0,0 +1,87 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+/** @file **/
+
+#ifndef SRC_THREAD_POOL_H_
+#define SRC_THREAD_POOL_H_
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osm2pgr {
+
+/** @brief fixed size pool of worker threads
+ *
+ * Tasks are executed in submission order by the first idle worker,
+ * the result (or the exception) is delivered through a std::future.
+ */
+class ThreadPool {
+ public:
+     /**
+      * @param threads number of workers, 0 means one per hardware thread
+      */
+     explicit ThreadPool(size_t threads = 0);
+
+     /** waits for the queued tasks and joins the workers */
+     ~ThreadPool();
+
+     ThreadPool(const ThreadPool&) = delete;
+     ThreadPool& operator=(const ThreadPool&) = delete;
+
+     inline size_t size() const {return m_workers.size();}
+
+     template <typename F>
+         auto
+         submit(F task) -> std::future<decltype(task())> {
+             typedef decltype(task()) R;
+             auto packaged = std::make_shared<std::packaged_task<R()>>(std::move(task));
+             auto result = packaged->get_future();
+             {
+                 std::lock_guard<std::mutex> lock(m_mutex);
+                 m_tasks.emplace_back([packaged]() {(*packaged)();});
+             }
+             m_cv.notify_one();
+             return result;
+         }
+
+     /** number of threads to use when the user did not ask for any */
+     static size_t default_size();
+
+ private:
+     void work();
+
+ private:
+     std::vector<std::thread> m_workers;
+     std::deque<std::function<void()>> m_tasks;
+     std::mutex m_mutex;
+     std::condition_variable m_cv;
+     bool m_stop;
+};
+
+}  // namespace osm2pgr
+
+#endif  // SRC_THREAD_POOL_H_
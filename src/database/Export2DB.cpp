@@ -20,12 +20,21 @@
 
 
 #include "database/Export2DB.h"
+#include "database/kept_splits.h"
 #include "database/table_management.h"
+#include "database/way_copy.h"
+#include "database/way_rows.h"
+#include "utilities/export_queue.h"
+#include "utilities/csr_graph.h"
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -38,31 +47,75 @@
 
 namespace osm2pgr {
 
-template <typename T>
+/*
+ * binary COPY data is sent in buffers of about this size
+ */
+static const size_t copy_buffer_size = 1 << 20;
+
+/*
+ * sends the buffer in slices of copy_buffer_size: PQputCopyData takes an int
+ */
+static
+bool
+put_copy(PGconn *mycon, CopyBuffer &buffer) {
+    auto ok = true;
+    for (size_t sent = 0; ok && sent < buffer.size(); sent += copy_buffer_size) {
+        auto size = std::min(copy_buffer_size, buffer.size() - sent);
+        ok = PQputCopyData(mycon, buffer.data() + sent, static_cast<int>(size)) == 1;
+    }
+    buffer.clear();
+    if (!ok) std::cerr << PQerrorMessage(mycon);
+    return ok;
+}
+
+/*
+ * ends the COPY, false when the server rejected the data
+ */
 static
-std::string
-TO_STR(const T &x) {
-    return  boost::lexical_cast<std::string>(x);
+bool
+end_copy(PGconn *mycon) {
+    if (PQputCopyEnd(mycon, nullptr) != 1) {
+        std::cerr << PQerrorMessage(mycon);
+        return false;
+    }
+    bool ok = true;
+    while (PGresult *res = PQgetResult(mycon)) {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+            std::cerr << PQresultErrorMessage(res);
+            ok = false;
+        }
+        PQclear(res);
+    }
+    return ok;
+}
+
+/*
+ * ends a COPY whose data could not be sent: the server discards the rows
+ */
+static
+void
+abort_copy(PGconn *mycon) {
+    if (PQputCopyEnd(mycon, "error") != 1) std::cerr << PQerrorMessage(mycon);
+    while (PGresult *res = PQgetResult(mycon)) PQclear(res);
 }
 
 
 Export2DB::Export2DB(const  po::variables_map &vm, const std::string &connection) :
     m_vm(vm),
     conninf(connection),
-    m_tables(vm)
+    m_tables(vm),
+    m_pool(connection),
+    m_temp_tables(0)
 {
 }
 
 Export2DB::~Export2DB() {
-#if 0
-    PQfinish(mycon);
-#endif
 }
 
 int Export2DB::connect() {
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        /* the session stays in the pool for the rest of the run */
+        auto session = m_pool.acquire();
         cout << "connection success"<< endl;
         return 0;
 
@@ -76,10 +129,9 @@ int Export2DB::connect() {
 bool
 Export2DB::has_extension(const std::string &name) const {
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
         std::string sql = "SELECT * FROM pg_extension WHERE extname = '" + name + "'";
-        auto result = Xaction.exec(sql);
+        auto result = session.exec(sql);
         return result.size() == 1;
 
     } catch (const std::exception &e) {
@@ -93,8 +145,8 @@ Export2DB::has_extension(const std::string &name) const {
 bool
 Export2DB::install_postGIS() const {
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
         Xaction.exec("CREATE EXTENSION postgis");
         Xaction.exec("CREATE EXTENSION hstore");
         Xaction.commit();
@@ -114,10 +166,9 @@ Export2DB::install_postGIS() const {
 
 bool Export2DB::exists(const std::string &table) const {
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
 
-        Xaction.exec(std::string("SELECT '") + table + "'::regclass");
+        session.exec(std::string("SELECT '") + table + "'::regclass");
         std::cout << "TABLE: " << vertices().addSchema() << " already exists.\n";
         return true;
     } catch (const std::exception &e) {
@@ -129,8 +180,8 @@ bool Export2DB::exists(const std::string &table) const {
 
 void Export2DB::createTables() const {
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
 
         if (!exists(vertices().addSchema())) {
             Xaction.exec(vertices().create());
@@ -152,6 +203,11 @@ void Export2DB::createTables() const {
             std::cout << "TABLE: " << configuration().addSchema() << " created ... OK.\n";
         }
 
+        if (m_vm.count("contract") && !exists(pieces().addSchema())) {
+            Xaction.exec(pieces().create());
+            std::cout << "TABLE: " << pieces().addSchema() << " created ... OK.\n";
+        }
+
 
         Xaction.commit();
     } catch (const std::exception &e) {
@@ -162,8 +218,8 @@ void Export2DB::createTables() const {
 
     if (m_vm.count("addnodes")) {
         try {
-            pqxx::connection db_conn(conninf);
-            pqxx::work Xaction(db_conn);
+            auto session = m_pool.acquire();
+            Transaction Xaction(session);
             /*
              * optional tables
              */
@@ -196,8 +252,8 @@ void Export2DB::createTables() const {
 
 void Export2DB::dropTables() const {
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
 
         Xaction.exec(ways().drop());
         std::cout << "TABLE: " << ways().addSchema() << " dropped ... OK.\n";
@@ -211,6 +267,9 @@ void Export2DB::dropTables() const {
         Xaction.exec(configuration().drop());
         std::cout << "TABLE: " << configuration().addSchema() << " dropped ... OK.\n";
 
+        Xaction.exec(pieces().drop());
+        std::cout << "TABLE: " << pieces().addSchema() << " dropped ... OK.\n";
+
         Xaction.commit();
     } catch (const std::exception &e) {
         cerr << e.what() << std::endl;
@@ -218,8 +277,8 @@ void Export2DB::dropTables() const {
     }
 
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
         Xaction.exec(osm_nodes().drop());
         std::cout << "TABLE: " << osm_nodes().addSchema() << " dropped ... OK.\n";
 
@@ -255,13 +314,19 @@ Export2DB::export_configuration(const std::map<std::string, Tag_key>& items) con
 void
 Export2DB::export_osm(
         const std::vector<std::string> &values,
-        const Table &table) const {
+        const Table &table,
+        bool binary) const {
     if (values.empty()) return;
 
+    /* the writer threads export chunks of the same table at the same time */
+    Table chunk_table(table);
+    chunk_table.temp_suffix("_" + std::to_string(++m_temp_tables));
+
     auto columns = table.columns();
-    std::string temp_table(table.temp_name());
-    auto create_sql = table.tmp_create();
-    std::string copy_sql( "COPY " + temp_table + " (" + comma_separated(columns) + ") FROM STDIN");
+    std::string temp_table(chunk_table.temp_name());
+    auto create_sql = chunk_table.tmp_create();
+    std::string copy_sql( "COPY " + temp_table + " (" + comma_separated(columns) + ") FROM STDIN"
+            + (binary ? " (FORMAT binary)" : ""));
 
 #if 0
     std::cout << "\n" << create_sql;
@@ -270,257 +335,497 @@ Export2DB::export_osm(
 #endif
 
     size_t count = 0;
+    bool copied(true);
     try {
+        /* the temporary table, the COPY and the insertion in one transaction */
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
+        Xaction.exec(create_sql);
+        Xaction.exec(copy_sql);
+
+        CopyBuffer buffer(binary);
+        buffer.header();
+        for (auto row = values.begin(); copied && row != values.end(); ++row) {
+            ++count;
+            buffer.append(*row);
+            if (buffer.size() >= copy_buffer_size) copied = put_copy(session.get(), buffer);
+        }
+        if (copied) {
+            buffer.trailer();
+            copied = put_copy(session.get(), buffer);
+        }
+        if (!copied) {
+            abort_copy(session.get());
+        } else {
+            copied = end_copy(session.get());
+        }
 
+        if (copied) {
+            Xaction.exec(m_tables.post_process(chunk_table));
+            Xaction.exec("DROP TABLE " + temp_table);
+            Xaction.commit();
+        }
+    } catch (const std::exception &e) {
+        std::cerr <<  "\n" << e.what() << std::endl;
+        std::cerr << "While exporting to " << table.addSchema() << " TODO insert one by one skip the guilty one\n";
+        return;
+    }
+    if (copied) return;
 
-        pqxx::connection db_con(conninf);
-        pqxx::work Xaction(db_con);
-        PGconn *mycon = PQconnectdb(conninf.c_str());
+    /* rolled back with its temporary table: each half is tried again */
+    if (values.size() < 2) {
+        for (const auto &v : values) {
+        std::cout << "\n*****ERROR HERE:\n" << (binary ? std::string("binary row") : v) << "\n******";
+        }
+        return;
+    }
+    size_t inc = values.size() / 2;
+    export_osm(std::vector<std::string>(values.begin(), values.begin() + inc), table, binary);
+    export_osm(std::vector<std::string>(values.begin() + inc , values.end()), table, binary);
+}
 
-        PGresult *res = PQexec(mycon, create_sql.c_str());
-        res = PQexec(mycon, copy_sql.c_str());
-        if (res) {};
 
-        for (auto it = values.begin(); it != values.end(); ++it) {
-            auto str = *it;
 
-            ++count;
 
-            PQputline(mycon, str.c_str());
+void Export2DB::load_vertices(VertexIds &vertices) const {
+    try {
+        auto session = m_pool.acquire();
+        auto result = session.exec("SELECT osm_id, id FROM " + this->vertices().addSchema());
+        for (size_t i = 0; i < result.size(); ++i) {
+            vertices.add_existing(result.get_int64(i, 0), result.get_int64(i, 1));
         }
+    } catch (const std::exception &e) {
+        std::cerr << "\n" << e.what() << std::endl;
+    }
+}
 
-        PQputline(mycon, "\\.\n");
 
-        if (PQendcopy(mycon) != 0) {
-            Xaction.exec("DROP TABLE " + temp_table);
-            PQfinish(mycon);
-            Xaction.commit();
 
-            if (values.size() < 2) {
-                for (const auto &v : values) {
-                std::cout << "\n*****ERROR HERE:\n" << v << "\n******";
-                }
-                return;
-            }
-            size_t inc = values.size() / 2;
-            export_osm(std::vector<std::string>(values.begin(), values.begin() + inc), table);
-            export_osm(std::vector<std::string>(values.begin() + inc , values.end()), table);
-            return;
-        };
 
-        PQfinish(mycon);
-        Xaction.exec(m_tables.post_process(table));
-        Xaction.exec("DROP TABLE " + temp_table);
-        Xaction.commit();
+
+void Export2DB::load_edges(EdgeKeys &edges) const {
+    try {
+        auto session = m_pool.acquire();
+        auto result = session.exec("SELECT osm_id, source_osm, target_osm FROM " + ways().addSchema());
+        for (size_t i = 0; i < result.size(); ++i) {
+            edges.add_existing(result.get_int64(i, 0), result.get_int64(i, 1), result.get_int64(i, 2));
+        }
+
+        /* the splits merged by --contract */
+        if (session.exec("SELECT 1 FROM pg_class WHERE oid = to_regclass('" + pieces().addSchema() + "')").size()) {
+            result = session.exec("SELECT osm_id, source_osm, target_osm FROM " + pieces().addSchema());
+            for (size_t i = 0; i < result.size(); ++i) {
+                edges.add_existing(result.get_int64(i, 0), result.get_int64(i, 1), result.get_int64(i, 2));
+            }
+        }
     } catch (const std::exception &e) {
-        std::cerr <<  "\n" << e.what() << std::endl;
-        std::cerr << "While exporting to " << table.addSchema() << " TODO insert one by one skip the guilty one\n";
+        std::cerr << "\n" << e.what() << std::endl;
     }
 }
 
 
 
 
-/*!
 
-*/
-void Export2DB::fill_vertices_table(
-        const std::string &table,
-        const std::string &vertices_tab,
-        pqxx::work &Xaction) const {
-    // std::cout << "Filling '" << vertices_tab << "' based on '" << table <<"'\n";
-    std::string sql(
-            "WITH osm_vertex AS ("
-            "(SELECT source_osm AS osm_id, x1 AS lon, y1 AS lat FROM " + table + " where source IS NULL)"
-            " union "
-            "(SELECT target_osm AS osm_id, x2 AS lon, y2 AS lat FROM " + table + " where target IS NULL)"
-            ") , "
-            " data1 AS (SELECT osm_id, lon, lat FROM (SELECT DISTINCT * FROM osm_vertex) a "
-            ") "
-            " INSERT INTO " + vertices_tab + " (osm_id, lon, lat, the_geom) (SELECT data1.*, ST_SetSRID(ST_Point(lon, lat), 4326) FROM data1)");
-    auto result = Xaction.exec(sql);
-
-    std::cout << "\t Vertices inserted: " << result.affected_rows();
+/*
+ * --bulk on an empty ways table
+ */
+bool Export2DB::bulk_load() const {
+    if (!m_vm.count("bulk")) return false;
+    if (get_val("SELECT count(*) FROM (SELECT 1 FROM " + ways().addSchema() + " LIMIT 1) AS a") == 0) return true;
+    std::cout << "    " << ways().addSchema() << " has rows: --bulk ignored, exporting in chunks\n";
+    return false;
 }
 
 
 
 
 
-void Export2DB::fill_source_target(
-        const std::string &table,
-        const std::string &vertices_tab,
-        pqxx::work &Xaction) const {
-    // std::cout << "    Filling 'source' column of '" << table << "':'" << vertices_tab << "'\n";
-    std::string sql1(
-            " UPDATE " + table + " AS w"
-            " SET source = v.id "
-            " FROM " + vertices_tab + " AS v"
-            " WHERE w.source IS NULL and w.source_osm = v.osm_id;");
-    Xaction.exec(sql1);
-
-    std::string sql2(
-            " UPDATE " + table + " AS w"
-            " SET target = v.id "
-            " FROM " + vertices_tab + " AS v"
-            " WHERE w.target IS NULL and w.target_osm = v.osm_id;");
-    Xaction.exec(sql2);
-
-    std::string sql3(
-            " UPDATE " + table +
-            " SET  length_m = ST_length(geography(ST_Transform(the_geom, 4326))),"
-            "      cost_s = CASE "
-            "           WHEN one_way = -1 THEN -ST_length(geography(ST_Transform(the_geom, 4326))) / (maxspeed_forward::float * 5.0 / 18.0)"
-            "           ELSE ST_length(geography(ST_Transform(the_geom, 4326))) / (maxspeed_backward::float * 5.0 / 18.0)"
-            "             END, "
-            "      reverse_cost_s = CASE "
-            "           WHEN one_way = 1 THEN -ST_length(geography(ST_Transform(the_geom, 4326))) / (maxspeed_backward::float * 5.0 / 18.0)"
-            "           ELSE ST_length(geography(ST_Transform(the_geom, 4326))) / (maxspeed_backward::float * 5.0 / 18.0)"
-            "             END "
-            " WHERE length_m IS NULL AND maxspeed_backward !=0 AND maxspeed_forward != 0;");
-    Xaction.exec(sql3);
+/*
+ * The ways are inserted before their vertices:
+ * the foreign keys of an earlier import are dropped while the ways are exported
+ */
+bool Export2DB::drop_vertex_fkeys() const {
+    bool dropped(false);
+    try {
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
+        auto result = Xaction.exec(
+                "SELECT conname FROM pg_constraint WHERE contype = 'f'"
+                " AND conrelid = '" + ways().addSchema() + "'::regclass"
+                " AND confrelid = '" + vertices().addSchema() + "'::regclass");
+        for (size_t i = 0; i < result.size(); ++i) {
+            Xaction.exec("ALTER TABLE " + ways().addSchema() + " DROP CONSTRAINT \"" + result.get(i, 0) + "\"");
+            dropped = true;
+        }
+        Xaction.commit();
+    } catch (const std::exception &e) {
+        std::cerr << "\n" << e.what() << std::endl;
+        return false;
+    }
+    return dropped;
 }
 
 
 
 
-void Export2DB::exportWays(const Ways &ways, const Configuration &config) const {
-    std::cout << "    Processing " <<  ways.size() <<  " ways"  << ":\n";
 
-    Table table = this->ways();
+void Export2DB::export_pieces(CopyBuffer &rows, size_t count) const {
+    if (!count) return;
 
-    auto columns = table.columns();
-    auto ways_columns = comma_separated(columns);
+    auto table = this->pieces();
+    std::string copy_sql("COPY " + table.addSchema() + " (" + comma_separated(table.columns()) + ") FROM STDIN"
+            + (rows.binary() ? " (FORMAT binary)" : ""));
 
-    size_t chunck_size = m_vm["chunk"].as<size_t>();
-
-    auto create_sql = table.tmp_create();
-    auto temp_table(table.temp_name());
+    try {
+        auto session = m_pool.acquire();
+        session.exec(copy_sql);
+        if (!put_copy(session.get(), rows)) {
+            abort_copy(session.get());
+            return;
+        }
+        if (end_copy(session.get())) std::cout << "    Pieces inserted: " << count << "\n";
+    } catch (const std::exception &e) {
+        std::cerr << "\n" << e.what() << std::endl;
+    }
+}
 
-    std::string copy_sql( "COPY " + temp_table + " (" + comma_separated(columns) + ") FROM STDIN");
 
+void Export2DB::export_vertices(
+        const VertexIds &vertices,
+        const VertexDegrees &degrees,
+        const std::vector<int64_t> &components) const {
+    const auto &added = vertices.added();
+    if (added.empty()) return;
 
-    int64_t split_count = 0;
-    int64_t count = 0;
-    size_t start = 0;
-    auto it = ways.begin();
+    auto table = this->vertices();
+    auto binary = binary_copy();
+    std::string copy_sql("COPY " + table.addSchema() + " (" + comma_separated(table.columns()) + ") FROM STDIN"
+            + (binary ? " (FORMAT binary)" : ""));
 
-    while (start < ways.size()) {
-        auto limit = (start + chunck_size) < ways.size() ? start + chunck_size : ways.size();
-        try {
-            pqxx::connection db_con(conninf);
-            pqxx::work Xaction(db_con);
-
-            PGconn *mycon = PQconnectdb(conninf.c_str());
-            PGresult *res = PQexec(mycon, create_sql.c_str());
-            res = PQexec(mycon, copy_sql.c_str());
-            if (res) {};
-
-
-            for (auto i = start; i < limit; ++i) {
-                auto way = *it;
-
-                ++count;
-                ++it;
-
-                if (way.tag_config().key() == "" || way.tag_config().value() == "") continue;
-
-                std::vector<std::string> common_values;
-                common_values.push_back(TO_STR(config.tag_value(way.tag_config()).id()));
-                common_values.push_back(TO_STR(way.osm_id()));
-                common_values.push_back(way.maxspeed_forward_str() == "-1" ? TO_STR(config.maxspeed_forward(way.tag_config())) : way.maxspeed_forward_str()) ;
-                common_values.push_back(way.maxspeed_backward_str() == "-1" ? TO_STR(config.maxspeed_backward(way.tag_config())) : way.maxspeed_backward_str()) ;
-                common_values.push_back(way.oneWayType_str());
-                common_values.push_back(way.oneWay());
-                // common_values.push_back(way.has_attribute("oneway") ? way.get_attribute("oneway") : std::string(""));
-                common_values.push_back(TO_STR(config.priority(way.tag_config())));
-
-                auto splits = way.split_me();
-                split_count +=  splits.size();
-                for (size_t j = 0; j < splits.size(); ++j) {
-                    auto length = way.length_str(splits[j]);
-
-                    auto values = common_values;
-                    values.push_back(length);
-                    values.push_back(splits[j].front()->lon());
-                    values.push_back(splits[j].front()->lat());
-                    values.push_back(splits[j].back()->lon());
-                    values.push_back(splits[j].back()->lat());
-                    values.push_back(TO_STR(splits[j].front()->osm_id()));
-                    values.push_back(TO_STR(splits[j].back()->osm_id()));
-                    values.push_back(way.geometry_str(splits[j]));
-
-                    // cost based on oneway
-                    if (way.is_reversed())
-                        values.push_back(std::string("-") + length);
-                    else
-                        values.push_back(length);
-
-                    // reverse_cost
-                    if (way.is_oneway())
-                        values.push_back(std::string("-") + length);
-                    else
-                        values.push_back(length);
-
-                    values.push_back(way.name());
-                    PQputline(mycon, tab_separated(values).c_str());
-                }
+    try {
+        /* the ids are given here, not by the sequence: it is moved past them in the same transaction */
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
+        Xaction.exec(copy_sql);
+
+        CopyBuffer rows(binary);
+        rows.header();
+        auto id = vertices.first_added();
+        auto sent = true;
+        for (const auto &vertex : added) {
+            const auto &degree = degrees.added(id);
+            rows.row(components.empty() ? 9 : 10);
+            rows.int8(id++);
+            rows.int8(vertex.osm_id);
+            rows.numeric(vertex.lon);
+            rows.numeric(vertex.lat);
+            rows.point(vertex.lon, vertex.lat);
+            rows.int4(degree.cnt);
+            rows.int4(degree.chk);
+            rows.int4(degree.ein);
+            rows.int4(degree.eout);
+            if (!components.empty()) rows.int8(components[id - 1 - vertices.first_added()]);
+            if (rows.size() >= copy_buffer_size) {
+                sent = put_copy(session.get(), rows);
+                if (!sent) break;
             }
+        }
+        if (sent) {
+            rows.trailer();
+            sent = put_copy(session.get(), rows);
+        }
+        /* the transaction is rolled back */
+        if (!sent) {
+            abort_copy(session.get());
+            return;
+        }
+        if (!end_copy(session.get())) return;
+
+        Xaction.exec("SELECT setval(pg_get_serial_sequence('" + table.addSchema() + "', 'id'), "
+                + std::to_string(id - 1) + ")");
+        Xaction.commit();
+        std::cout << "    Vertices inserted: " << added.size() << "\n";
+    } catch (const std::exception &e) {
+        std::cerr << "\n" << e.what() << std::endl;
+    }
+}
 
-            PQputline(mycon, "\\.\n");
-            PQendcopy(mycon);
 
-            print_progress(ways.size(), count);
-            process_section(ways_columns, Xaction);
-            Xaction.exec("DROP TABLE " + temp_table);
+/*
+ * the rows of earlier imports reach these vertices too: their counts are
+ * taken again on the ways table, chk is kept when it was set
+ */
+void Export2DB::update_degrees(const VertexDegrees &degrees) const {
+    const auto &existing = degrees.existing();
+    if (existing.empty()) return;
+
+    /* the vertices are copied to a temporary table: the statement does not grow with them */
+    auto binary = binary_copy();
+    CopyBuffer rows(binary);
+    rows.header();
+    for (const auto &vertex : existing) {
+        rows.row(2);
+        rows.int8(vertex.first);
+        rows.int4(vertex.second.chk);
+    }
+    rows.trailer();
+
+    Table table = vertices();
+    table.temp_suffix("_degrees");
+    auto temp_table(table.temp_name());
+
+    std::string sql(
+            "UPDATE " + vertices().addSchema() + " AS v"
+            " SET cnt = d.cnt, ein = d.ein, eout = d.eout, chk = GREATEST(COALESCE(v.chk, 0), t.chk)"
+            " FROM " + temp_table + " AS t,"
+            " LATERAL (SELECT"
+            " COALESCE(sum((w.source = t.id)::int + (w.target = t.id)::int), 0) AS cnt,"
+            " COALESCE(sum((w.source = t.id AND w.one_way <> 1)::int"
+            " + (w.target = t.id AND w.one_way <> -1)::int), 0) AS ein,"
+            " COALESCE(sum((w.source = t.id AND w.one_way <> -1)::int"
+            " + (w.target = t.id AND w.one_way <> 1)::int), 0) AS eout"
+            " FROM " + ways().addSchema() + " AS w WHERE w.source = t.id OR w.target = t.id) AS d"
+            " WHERE v.id = t.id");
+
+    try {
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
+        Xaction.exec("CREATE TEMP TABLE " + temp_table + " (id bigint, chk integer) ON COMMIT DROP");
+        Xaction.exec("COPY " + temp_table + " (id, chk) FROM STDIN" + (binary ? " (FORMAT binary)" : ""));
+        auto sent = put_copy(session.get(), rows);
+        if (!sent) abort_copy(session.get());
+        if (sent && end_copy(session.get())) {
+            Xaction.exec("ANALYZE " + temp_table);
+            Xaction.exec(sql);
             Xaction.commit();
-        } catch (const std::exception &e) {
-            std::cerr <<  "\n" << e.what() << std::endl;
-            std::cerr << "While processing FROM " << start << "th \t to: " << limit << "th way\n";
-            std::cerr << "count" << count << " While processing FROM " << start << "th \t to: " << limit << "th way\n";
+            std::cout << "    Vertices of the table updated: " << existing.size() << "\n";
+            return;
         }
-
-        start = limit;
+    } catch (const std::exception &e) {
+        std::cerr << "\n" << e.what() << std::endl;
     }
+    std::cerr << "While updating the vertices of " << vertices().addSchema() << "\n";
 }
 
 
 
-void Export2DB::process_section(const std::string &ways_columns, pqxx::work &Xaction) const {
-    //  std::cout << "Creating indices in temporary table\n";
-    auto temp_table(ways().temp_name());
 
-    Xaction.exec("CREATE INDEX "+ temp_table + "_gdx ON "+ temp_table + " using gist(the_geom);");
-    Xaction.exec("CREATE INDEX ON "+ temp_table + "  USING btree (source_osm)");
-    Xaction.exec("CREATE INDEX ON "+ temp_table + "  USING btree (target_osm)");
+bool Export2DB::exportWays(
+        const Ways &ways,
+        const Configuration &config,
+        const NodeResolver &resolve) const {
+    std::cout << "    Processing " <<  ways.size() <<  " ways"  << ":\n";
+    auto begin = std::chrono::steady_clock::now();
 
+    Table table = this->ways();
 
+    size_t chunck_size = m_vm["chunk"].as<size_t>();
+    size_t threads = m_vm["threads"].as<size_t>();
+    if (threads == 0) threads = 1;
 
+    auto binary = binary_copy();
+    auto bulk = bulk_load();
+    std::string copy_sql( "COPY " + table.addSchema() + " (" + comma_separated(table.columns()) + ") FROM STDIN"
+            + (binary ? " (FORMAT binary)" : ""));
 
-    //  std::cout << "Deleting  duplicated ways FROM temporary table\n";
-    std::string delete_from_temp(
-            " DELETE FROM "+ temp_table + " a "
-            "     USING " + ways().addSchema() + " b "
-            "     WHERE a.the_geom ~= b.the_geom AND ST_OrderingEquals(a.the_geom, b.the_geom);");
-    Xaction.exec(delete_from_temp);
 
-    //  std::cout << "Updating to existing toplology the temporary table\n";
-    fill_source_target(temp_table, vertices().addSchema(), Xaction);
+    size_t start = 0;
 
-    //  std::cout << "Inserting new vertices in the vertex table\n";
-    fill_vertices_table(temp_table, vertices().addSchema(), Xaction);
+    /* the vertices are numbered while the ways are written */
+    VertexIds vertex_ids;
+    load_vertices(vertex_ids);
+    /* cnt, chk, ein and eout of the vertices, counted as the rows are numbered */
+    VertexDegrees degrees(vertex_ids.first_added());
+    /* the splits written by this run or an earlier one are skipped */
+    EdgeKeys edge_keys;
+    load_edges(edge_keys);
+    auto had_fkeys = drop_vertex_fkeys();
+
+    /* with --components or --prune the rows and the vertices get their component */
+    auto prune = m_vm["prune"].as<size_t>();
+    auto components = m_vm.count("components") != 0 || prune > 0;
+
+    /* the gids follow the ones on the table */
+    WayRows way_rows(config, vertex_ids, edge_keys,
+            get_val("SELECT COALESCE(max(gid), 0) FROM " + table.addSchema()), components);
+    auto first_gid = way_rows.last_gid();
 
-    //  std::cout << "Updating to new toplology the temporary table\n";
-    fill_source_target(temp_table, vertices().addSchema(), Xaction);
+    /*
+     * With --hilbert, --contract or --components the splits kept are gathered before they are numbered
+     * and the rows follow the chains (one split each without --contract)
+     */
+    auto hilbert = m_vm.count("hilbert") != 0;
+    auto contract = m_vm.count("contract") != 0;
+    auto kept_first = hilbert || contract || components;
+    KeptSplits chains(ways, resolve);
+    std::vector<int64_t> vertex_components;
+    if (kept_first) {
+        chains.gather(way_rows);
+        if (contract) {
+            chains.contract(vertex_ids, std::cout);
+        } else {
+            chains.single();
+        }
+        if (components) chains.components(vertex_ids, prune, std::cout);
+        if (hilbert) chains.hilbert(vertex_ids, std::cout);
+        /* the vertices take their ids before the rows are written, so the component is known from the first row */
+        if (components) vertex_components = chains.label_components(vertex_ids);
+    }
+
+    /* with --csr the edges are kept for the graph file */
+    auto csr = m_vm.count("csr") != 0;
+    WayCopy way_copy(ways, resolve, way_rows, degrees, kept_first ? &chains : nullptr,
+            binary, m_vm["split-threads"].as<size_t>(), csr);
+    auto total = way_copy.size();
 
+    /* false once a COPY of the ways failed: the stages writing what depends on the rows are skipped */
+    std::atomic<bool> copied(true);
 
-    //  std::cout << "Inserting new split ways to '" << addSchema(full_table_name("ways")) << "'\n";
-    std::string insert_into_ways(
-            " INSERT INTO " + ways().addSchema() +
-            "(" + ways_columns + ", source, target, length_m, cost_s, reverse_cost_s) "
-            " (SELECT " + ways_columns + ", source, target, length_m, cost_s, reverse_cost_s FROM " + temp_table + "); ");
-    auto result = Xaction.exec(insert_into_ways);
-    std::cout << "\tSplit ways inserted " << result.affected_rows() << "\n";
+    if (bulk && threads == 1) {
+        /*
+         * one COPY into the ways table, the indexes are built at the end by createFKeys
+         */
+        try {
+            auto session = m_pool.acquire();
+            session.exec(copy_sql);
+            CopyBuffer rows(binary);
+            rows.reserve(copy_buffer_size + copy_buffer_size / 4);
+            rows.header();
+            WayCopy::Sink send = [&session](CopyBuffer &buffer) {
+                return buffer.size() < copy_buffer_size || put_copy(session.get(), buffer);
+            };
+            auto sent = true;
+            while (sent && start < total) {
+                auto limit = (start + chunck_size) < total ? start + chunck_size : total;
+                sent = way_copy.copy(rows, start, limit, send);
+                print_progress(total, way_copy.count());
+                start = limit;
+            }
+            if (sent) {
+                rows.trailer();
+                sent = put_copy(session.get(), rows);
+            }
+            if (!sent) {
+                abort_copy(session.get());
+                std::cerr << "While copying the split ways, stopped at the " << way_copy.count() << "th\n";
+                copied = false;
+            } else if (end_copy(session.get())) {
+                std::cout << "\tSplit ways inserted " << way_copy.split_count() << "\n";
+            } else {
+                copied = false;
+            }
+        } catch (const std::exception &e) {
+            std::cerr <<  "\n" << e.what() << std::endl;
+            copied = false;
+        }
+        start = total;
+    }
+
+    /*
+     * The rows of a chunk are written on this thread, in the order of the ways,
+     * and copied by one of the writers on its own connection.
+     */
+    ExportQueue writers(threads, 2 * threads);
+    while (copied && start < total) {
+        auto limit = (start + chunck_size) < total ? start + chunck_size : total;
+        auto rows = std::make_shared<CopyBuffer>(binary);
+        rows->header();
+        way_copy.copy(*rows, start, limit);
+        rows->trailer();
+        print_progress(total, way_copy.count());
+
+        writers.push([this, rows, start, limit, &copied]() {
+                if (!copy_ways_chunk(*rows, start, limit)) copied = false;
+                });
+        start = limit;
+    }
+    writers.finish();
+    if (copied && writers.tasks()) std::cout << "\tSplit ways inserted " << way_copy.split_count() << "\n";
+
+    if (!copied) {
+        /* the sequence follows the rows committed */
+        execute("SELECT setval(pg_get_serial_sequence('" + table.addSchema() + "', 'gid'), max(gid))"
+                " FROM " + table.addSchema() + " HAVING max(gid) > " + std::to_string(first_gid));
+        std::cerr << "The split ways were not all copied, skipped: the vertices and their degrees"
+            << (contract ? ", the pieces" : "") << (csr ? ", the CSR graph" : "")
+            << (had_fkeys ? ", the foreign keys to the vertices" : "") << "\n";
+        return false;
+    }
+
+    if (way_rows.last_gid() > first_gid) {
+        execute("SELECT setval(pg_get_serial_sequence('" + table.addSchema() + "', 'gid'), "
+                + std::to_string(way_rows.last_gid()) + ")");
+    }
+    if (edge_keys.duplicates()) {
+        std::cout << "    Duplicated split ways skipped: " << edge_keys.duplicates() << "\n";
+    }
+    export_vertices(vertex_ids, degrees, vertex_components);
+    update_degrees(degrees);
+    degrees.print(std::cout);
+    if (chains.pruned_rows()) {
+        std::cout << "    Components pruned below " << prune << " vertices: " << chains.pruned_components()
+            << " components, " << chains.pruned_rows() << " rows\n";
+    }
+    if (contract) {
+        way_copy.piece_rows().trailer();
+        export_pieces(way_copy.piece_rows(), way_copy.piece_count());
+    }
+    if (had_fkeys) {
+        execute(this->ways().foreign_key("source", vertices(), "id"));
+        execute(this->ways().foreign_key("target", vertices(), "id"));
+        execute(this->ways().foreign_key("source_osm", vertices(), "osm_id"));
+        execute(this->ways().foreign_key("target_osm", vertices(), "osm_id"));
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << "    Ways exported in " << elapsed.count() << " seconds"
+        << (bulk && threads == 1 ? " (bulk" : " (chunks of " + std::to_string(chunck_size) + (kept_first ? " rows" : " ways"))
+        << (contract ? ", contracted" : "")
+        << (hilbert ? ", Hilbert order" : "")
+        << (threads > 1 ? ", " + std::to_string(threads) + " connections)" : std::string(")")) << "\n";
+
+    if (csr) {
+        try {
+            begin = std::chrono::steady_clock::now();
+            auto header = CsrGraph::write(m_vm["csr"].as<std::string>(), way_copy.edges());
+            elapsed = std::chrono::steady_clock::now() - begin;
+            std::cout << "    CSR graph " << m_vm["csr"].as<std::string>() << ": "
+                << header.vertices << " vertices, " << header.edges << " edges, "
+                << header.file_size << " bytes written in " << elapsed.count() << " seconds\n";
+        } catch (const std::exception &e) {
+            std::cerr <<  "\n" << e.what() << std::endl;
+        }
+    }
+    return true;
+}
+
+
+
+/*
+ * the COPY in the transaction of the chunk: the rows of a chunk are committed all or none,
+ * the chunks copied at the same time have distinct gids
+ */
+bool Export2DB::copy_ways_chunk(CopyBuffer &rows, size_t start, size_t limit) const {
+    Table table = ways();
+    std::string copy_sql( "COPY " + table.addSchema() + " (" + comma_separated(table.columns()) + ") FROM STDIN"
+            + (rows.binary() ? " (FORMAT binary)" : ""));
+
+    try {
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
+        Xaction.exec(copy_sql);
+        auto sent = put_copy(session.get(), rows);
+        if (!sent) abort_copy(session.get());
+        if (sent && end_copy(session.get())) {
+            Xaction.commit();
+            return true;
+        }
+    } catch (const std::exception &e) {
+        std::cerr <<  "\n" << e.what() << std::endl;
+    }
+    std::cerr << "While processing FROM " << start << "th \t to: " << limit << "th way\n";
+    return false;
 }
 
 
@@ -533,12 +838,12 @@ Export2DB::get_val(const std::string sql) const {
     std::cout << "\nExecuting: \n" << sql << "\n";
 #endif
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
         auto result = Xaction.exec(sql);
         Xaction.commit();
         if (result.size() == 0) return 0;
-        return result[0][0].as<int64_t>();
+        return result.get_int64(0, 0);
     } catch (const std::exception &e) {
         std::cout << "\nWARNING: " << e.what() << std::endl;
         std::cout <<  sql << "\n";
@@ -552,8 +857,8 @@ Export2DB::execute(const std::string sql) const {
     std::cout << "\nExecuting: \n" << sql << "\n";
 #endif
     try {
-        pqxx::connection db_conn(conninf);
-        pqxx::work Xaction(db_conn);
+        auto session = m_pool.acquire();
+        Transaction Xaction(session);
         Xaction.exec(sql);
         Xaction.commit();
     } catch (const std::exception &e) {
@@ -598,6 +903,15 @@ void Export2DB::createFKeys() const {
     execute(ways().foreign_key("tag_id", configuration(), "tag_id"));
     execute(ways().gist_index());
 
+    /*
+     * the pieces of the contracted ways
+     */
+    if (m_vm.count("contract")) {
+        execute(pieces().foreign_key("gid", ways(), "gid"));
+        execute("CREATE INDEX ON " + pieces().addSchema() + " (gid)");
+        execute("CREATE INDEX ON " + pieces().addSchema() + " (osm_id)");
+    }
+
     /*
      * ponitsOfInterest
      */
@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/components.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace osm2pgr {
+
+
+size_t
+Components::index(int64_t osm_id) {
+    auto inserted = m_index.emplace(osm_id, m_parent.size());
+    if (inserted.second) {
+        m_parent.push_back(m_parent.size());
+        m_size.push_back(1);
+        ++m_components;
+    }
+    return inserted.first->second;
+}
+
+
+/*
+ * path halving
+ */
+size_t
+Components::root(size_t vertex) {
+    while (m_parent[vertex] != vertex) {
+        m_parent[vertex] = m_parent[m_parent[vertex]];
+        vertex = m_parent[vertex];
+    }
+    return vertex;
+}
+
+
+/*
+ * union by size
+ */
+void
+Components::add(int64_t source_osm, int64_t target_osm) {
+    auto a = root(index(source_osm));
+    auto b = root(index(target_osm));
+    if (a == b) return;
+    if (m_size[a] < m_size[b]) std::swap(a, b);
+    m_parent[b] = a;
+    m_size[a] += m_size[b];
+    --m_components;
+}
+
+
+size_t
+Components::find(int64_t osm_id) {
+    return root(m_index.at(osm_id));
+}
+
+
+void
+Components::print(std::ostream &out) {
+    std::vector<size_t> decades;
+    size_t largest = 0;
+    for (size_t vertex = 0; vertex < m_parent.size(); ++vertex) {
+        if (root(vertex) != vertex) continue;
+        auto size = m_size[vertex];
+        largest = std::max(largest, size);
+        size_t decade = 0;
+        for (auto s = size; s >= 10; s /= 10) ++decade;
+        if (decades.size() <= decade) decades.resize(decade + 1, 0);
+        ++decades[decade];
+    }
+
+    out << "    Connected components: " << m_components << ", the largest has " << largest << " of "
+        << m_parent.size() << " vertices\n";
+    size_t low = 1;
+    for (size_t decade = 0; decade < decades.size(); ++decade, low *= 10) {
+        if (!decades[decade]) continue;
+        out << "\t" << low << "-" << 10 * low - 1 << " vertices: " << decades[decade] << " components\n";
+    }
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,169 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/connection_pool.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace osm2pgr {
+
+namespace {
+
+/*
+ * ends an unfinished COPY and rolls back the open transaction
+ */
+void
+roll_back(PGconn *conn) {
+    if (PQstatus(conn) != CONNECTION_OK) return;
+    if (PQtransactionStatus(conn) == PQTRANS_ACTIVE) {
+        PQputCopyEnd(conn, "aborted");
+        while (PGresult *res = PQgetResult(conn)) PQclear(res);
+    }
+    if (PQtransactionStatus(conn) != PQTRANS_IDLE) {
+        PQclear(PQexec(conn, "ROLLBACK"));
+    }
+}
+
+}  // namespace
+
+
+size_t
+SqlResult::affected_rows() const {
+    return static_cast<size_t>(std::strtoull(PQcmdTuples(m_result.get()), nullptr, 10));
+}
+
+
+int64_t
+SqlResult::get_int64(size_t row, int column) const {
+    return static_cast<int64_t>(std::strtoll(get(row, column).c_str(), nullptr, 10));
+}
+
+
+
+ConnectionPool::Session::Session(Session &&other) :
+    m_pool(other.m_pool),
+    m_conn(other.m_conn) {
+    other.m_conn = nullptr;
+}
+
+
+ConnectionPool::Session::~Session() {
+    if (m_conn) m_pool->release(m_conn);
+}
+
+
+SqlResult
+ConnectionPool::Session::exec(const std::string &sql) {
+    auto res = PQexec(m_conn, sql.c_str());
+    switch (PQresultStatus(res)) {
+        case PGRES_COMMAND_OK:
+        case PGRES_TUPLES_OK:
+        case PGRES_COPY_IN:
+            return SqlResult(res);
+        default:
+            break;
+    }
+    std::string message(res ? PQresultErrorMessage(res) : PQerrorMessage(m_conn));
+    PQclear(res);
+    throw std::runtime_error(message + sql);
+}
+
+
+
+ConnectionPool::~ConnectionPool() {
+    for (auto conn : m_idle) PQfinish(conn);
+}
+
+
+ConnectionPool::Session
+ConnectionPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idle.empty()) {
+            auto conn = m_idle.back();
+            m_idle.pop_back();
+            return Session(this, conn);
+        }
+    }
+
+    auto conn = PQconnectdb(m_conninfo.c_str());
+    if (PQstatus(conn) != CONNECTION_OK) {
+        std::string message(PQerrorMessage(conn));
+        PQfinish(conn);
+        throw std::runtime_error(message);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_opened;
+    return Session(this, conn);
+}
+
+
+size_t
+ConnectionPool::opened() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_opened;
+}
+
+
+/*
+ * a session left in a transaction (an exception in the middle of a COPY)
+ * is rolled back, a broken connection is closed
+ */
+void
+ConnectionPool::release(PGconn *conn) {
+    roll_back(conn);
+    if (PQstatus(conn) != CONNECTION_OK || PQtransactionStatus(conn) != PQTRANS_IDLE) {
+        PQfinish(conn);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle.push_back(conn);
+}
+
+
+
+Transaction::Transaction(ConnectionPool::Session &session) :
+    m_session(session),
+    m_open(true) {
+    m_session.exec("BEGIN");
+}
+
+
+Transaction::~Transaction() {
+    if (m_open) roll_back(m_session.get());
+}
+
+
+/*
+ * COMMIT of a failed transaction answers ROLLBACK
+ */
+void
+Transaction::commit() {
+    m_open = false;
+    auto result = m_session.exec("COMMIT");
+    if (result.status() != "COMMIT") throw std::runtime_error("transaction rolled back");
+}
+
+}  // namespace osm2pgr
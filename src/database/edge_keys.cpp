@@ -0,0 +1,135 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/edge_keys.h"
+
+#include <utility>
+
+namespace osm2pgr {
+
+namespace {
+
+/* splitmix64 finalizer */
+inline
+uint64_t
+mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline
+uint64_t
+combine(uint64_t hash, int64_t value) {
+    return mix(hash + 0x9e3779b97f4a7c15ULL + static_cast<uint64_t>(value));
+}
+
+inline
+uint64_t
+segment_key(int64_t osm_id, int64_t source_osm, int64_t target_osm) {
+    return combine(combine(combine(0, osm_id), source_osm), target_osm);
+}
+
+}  // namespace
+
+
+void
+EdgeKeys::KeySet::insert(uint64_t hash, uint64_t position) {
+    if (2 * (m_size + 1) > m_slots.size()) grow();
+
+    auto mask = m_slots.size() - 1;
+    auto i = static_cast<size_t>(hash) & mask;
+    while (m_slots[i].position != npos) i = (i + 1) & mask;
+    m_slots[i] = Slot{hash, position};
+    ++m_size;
+}
+
+
+void
+EdgeKeys::KeySet::grow() {
+    std::vector<Slot> slots(m_slots.empty() ? 1024 : 2 * m_slots.size(), Slot{0, npos});
+    std::swap(slots, m_slots);
+
+    auto mask = m_slots.size() - 1;
+    for (const auto &slot : slots) {
+        if (slot.position == npos) continue;
+        auto i = static_cast<size_t>(slot.hash) & mask;
+        while (m_slots[i].position != npos) i = (i + 1) & mask;
+        m_slots[i] = slot;
+    }
+}
+
+
+void
+EdgeKeys::add_existing(int64_t osm_id, int64_t source_osm, int64_t target_osm) {
+    m_existing.insert(segment_key(osm_id, source_osm, target_osm), m_segments.size());
+    m_segments.push_back(osm_id);
+    m_segments.push_back(source_osm);
+    m_segments.push_back(target_osm);
+}
+
+
+bool
+EdgeKeys::insert(
+        int64_t osm_id,
+        const std::vector<Node*> &nodeRefs,
+        size_t first, size_t last) {
+    auto source_osm = nodeRefs[first]->osm_id();
+    auto target_osm = nodeRefs[last]->osm_id();
+    if (!m_existing.empty()) {
+        auto found = m_existing.find(segment_key(osm_id, source_osm, target_osm), [&](uint64_t position) {
+                return m_segments[position] == osm_id
+                    && m_segments[position + 1] == source_osm
+                    && m_segments[position + 2] == target_osm;});
+        if (found != KeySet::npos) {
+            ++m_duplicates;
+            return false;
+        }
+    }
+
+    auto count = static_cast<int64_t>(last - first + 1);
+    uint64_t key = last - first;
+    for (auto i = first; i <= last; ++i) {
+        key = combine(key, nodeRefs[i]->osm_id());
+    }
+    auto found = m_nodes.find(key, [&](uint64_t position) {
+            if (m_node_ids[position] != count) return false;
+            for (auto i = first; i <= last; ++i) {
+                if (m_node_ids[++position] != nodeRefs[i]->osm_id()) return false;
+            }
+            return true;});
+    if (found != KeySet::npos) {
+        ++m_duplicates;
+        return false;
+    }
+
+    m_nodes.insert(key, m_node_ids.size());
+    m_node_ids.push_back(count);
+    for (auto i = first; i <= last; ++i) m_node_ids.push_back(nodeRefs[i]->osm_id());
+    return true;
+}
+
+}  // namespace osm2pgr
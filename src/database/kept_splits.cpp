@@ -0,0 +1,256 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/kept_splits.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "utilities/hilbert.h"
+
+namespace osm2pgr {
+
+
+const VertexIds::Vertex&
+KeptSplits::source(const Chain &chain) const {
+    const auto &link = m_links[chain.first];
+    return link.reversed ? m_kept[link.split].target : m_kept[link.split].source;
+}
+
+
+const VertexIds::Vertex&
+KeptSplits::target(const Chain &chain) const {
+    const auto &link = m_links[chain.first + chain.size - 1];
+    return link.reversed ? m_kept[link.split].source : m_kept[link.split].target;
+}
+
+
+void
+KeptSplits::gather(WayRows &way_rows) {
+    std::vector<Node> nodes;
+    std::vector<Node*> refs;
+    std::vector<WayRows::Split> splits;
+    for (size_t i = 0; i < m_ways.size(); ++i) {
+        const auto &way = m_ways[i];
+        if (!way.is_tag_configured()) continue;
+        const auto *nodeRefs = &way.nodeRefs();
+        if (m_resolve) {
+            m_resolve(way, nodes, refs);
+            nodeRefs = &refs;
+        }
+
+        splits.clear();
+        way_rows.keep(way, *nodeRefs, splits);
+        for (const auto &split : splits) {
+            const auto &source = *(*nodeRefs)[split.first];
+            const auto &target = *(*nodeRefs)[split.last];
+            m_kept.push_back(Kept{i, split,
+                    VertexIds::Vertex{source.osm_id(), source.lat_e7(), source.lon_e7()},
+                    VertexIds::Vertex{target.osm_id(), target.lat_e7(), target.lon_e7()}});
+        }
+    }
+}
+
+
+void
+KeptSplits::single() {
+    for (size_t i = 0; i < m_kept.size(); ++i) {
+        m_links.push_back(WayChains::Link{i, false});
+        m_chains.push_back(Chain{0, i, 1, 0});
+    }
+}
+
+
+void
+KeptSplits::contract(const VertexIds &vertex_ids, std::ostream &out) {
+    WayChains way_chains;
+    for (const auto &piece : m_kept) {
+        way_chains.add(piece.source.osm_id, piece.target.osm_id,
+                WayChains::attributes(m_ways[piece.way], piece.split));
+    }
+    way_chains.build([&vertex_ids](int64_t osm_id) {return vertex_ids.has(osm_id);});
+    m_links.reserve(m_kept.size());
+    for (size_t c = 0; c < way_chains.size(); ++c) {
+        m_chains.push_back(Chain{0, m_links.size(), way_chains.links_size(c), 0});
+        m_links.insert(m_links.end(), way_chains.links(c), way_chains.links(c) + way_chains.links_size(c));
+    }
+    m_contracted = true;
+    out << "    Split ways merged through vertices of degree 2: " << m_kept.size()
+        << " split ways, " << m_chains.size() << " rows, "
+        << way_chains.removed() << " vertices removed\n";
+}
+
+
+void
+KeptSplits::components(const VertexIds &vertex_ids, size_t prune, std::ostream &out) {
+    for (const auto &chain : m_chains) {
+        m_components.add(source(chain).osm_id, target(chain).osm_id);
+    }
+    m_has_components = true;
+    m_components.print(out);
+    if (prune == 0) return;
+
+    /* the components reaching the vertices on the table are joined to rows this run does not see */
+    std::vector<bool> kept_component(m_components.vertices(), false);
+    for (const auto &chain : m_chains) {
+        for (const auto *vertex : {&source(chain), &target(chain)}) {
+            if (vertex_ids.has(vertex->osm_id)) kept_component[m_components.find(vertex->osm_id)] = true;
+        }
+    }
+    std::vector<bool> pruned(m_components.vertices(), false);
+    auto small = [&](const Chain &chain) {
+        auto component = m_components.find(source(chain).osm_id);
+        if (kept_component[component] || m_components.vertices(component) >= prune) return false;
+        if (!pruned[component]) {
+            pruned[component] = true;
+            ++m_pruned_components;
+        }
+        return true;
+    };
+    auto end = std::remove_if(m_chains.begin(), m_chains.end(), small);
+    m_pruned_rows = static_cast<size_t>(m_chains.end() - end);
+    m_chains.erase(end, m_chains.end());
+}
+
+
+void
+KeptSplits::hilbert(VertexIds &vertex_ids, std::ostream &out) {
+    auto key = [](const VertexIds::Vertex &a, const VertexIds::Vertex &b) {
+        return hilbert_key(
+                static_cast<int32_t>((static_cast<int64_t>(a.lon) + b.lon) / 2),
+                static_cast<int32_t>((static_cast<int64_t>(a.lat) + b.lat) / 2));
+    };
+    struct Vertex {
+        uint64_t key;
+        VertexIds::Vertex vertex;
+    };
+    std::vector<Vertex> ends;
+    for (auto &chain : m_chains) {
+        const auto &from = source(chain);
+        const auto &to = target(chain);
+        chain.key = key(from, to);
+        for (const auto *vertex : {&from, &to}) {
+            ends.push_back(Vertex{hilbert_key(vertex->lon, vertex->lat), *vertex});
+        }
+    }
+
+    std::sort(ends.begin(), ends.end(), [](const Vertex &a, const Vertex &b) {
+            return a.key != b.key ? a.key < b.key : a.vertex.osm_id < b.vertex.osm_id;});
+    for (const auto &end : ends) vertex_ids.id(Node(end.vertex.osm_id, end.vertex.lat, end.vertex.lon));
+    std::vector<Vertex>().swap(ends);
+
+    /* the splits of a way stay in their order when the keys are equal */
+    std::sort(m_chains.begin(), m_chains.end(), [this](const Chain &a, const Chain &b) {
+            if (a.key != b.key) return a.key < b.key;
+            const auto &ka = m_kept[m_links[a.first].split];
+            const auto &kb = m_kept[m_links[b.first].split];
+            return ka.way != kb.way ? ka.way < kb.way : ka.split.first < kb.split.first;});
+    out << "    " << (m_contracted ? "Rows" : "Split ways") << " sorted along a Hilbert curve: "
+        << m_chains.size() << "\n";
+}
+
+
+std::vector<int64_t>
+KeptSplits::label_components(VertexIds &vertex_ids) {
+    std::vector<int64_t> labels(m_components.vertices(), std::numeric_limits<int64_t>::max());
+    for (const auto &chain : m_chains) {
+        for (const auto *vertex : {&source(chain), &target(chain)}) {
+            auto &label = labels[m_components.find(vertex->osm_id)];
+            label = std::min(label, vertex_ids.id(Node(vertex->osm_id, vertex->lat, vertex->lon)));
+        }
+    }
+    for (auto &chain : m_chains) chain.component = labels[m_components.find(source(chain).osm_id)];
+
+    std::vector<int64_t> vertex_components;
+    vertex_components.reserve(vertex_ids.added().size());
+    for (const auto &vertex : vertex_ids.added()) {
+        vertex_components.push_back(labels[m_components.find(vertex.osm_id)]);
+    }
+    return vertex_components;
+}
+
+
+void
+KeptSplits::number(size_t chain, WayRows &way_rows, std::vector<WayRows::Split> &splits) const {
+    const auto &row = m_chains[chain];
+    const auto &from = source(row);
+    const auto &to = target(row);
+    auto split = m_kept[m_links[row.first].split].split;
+    split.component = row.component;
+    for (size_t l = 1; l < row.size; ++l) {
+        const auto &piece = m_kept[m_links[row.first + l].split].split;
+        split.zero_length = split.zero_length && piece.zero_length;
+        split.repeated_nodes = split.repeated_nodes || piece.repeated_nodes;
+    }
+    way_rows.number(split,
+            Node(from.osm_id, from.lat, from.lon),
+            Node(to.osm_id, to.lat, to.lon));
+    splits.push_back(split);
+}
+
+
+size_t
+KeptSplits::pieces(size_t chain, const WayRows::Split &split, CopyBuffer &rows) const {
+    const auto &row = m_chains[chain];
+    for (size_t l = 0; l < row.size; ++l) {
+        const auto &link = m_links[row.first + l];
+        const auto &piece = m_kept[link.split];
+        rows.row(6);
+        rows.int8(split.gid);
+        rows.int4(static_cast<int32_t>(l + 1));
+        rows.int8(m_ways[piece.way].osm_id());
+        rows.int8(piece.source.osm_id);
+        rows.int8(piece.target.osm_id);
+        rows.boolean(link.reversed);
+    }
+    return row.size;
+}
+
+
+void
+KeptSplits::write(
+        size_t chain,
+        const WayRows::Split &split,
+        const WayRows &way_rows,
+        CopyBuffer &rows,
+        WayRows::Coordinates &coordinates,
+        Pieces &pieces,
+        std::vector<CsrGraph::Edge> *edges) const {
+    const auto &row = m_chains[chain];
+    pieces.pieces.clear();
+    for (size_t l = 0; l < row.size; ++l) {
+        const auto &link = m_links[row.first + l];
+        const auto &piece = m_kept[link.split];
+        const auto &way = m_ways[piece.way];
+        const auto *nodeRefs = &way.nodeRefs();
+        if (m_resolve) {
+            if (pieces.nodes.size() <= l) pieces.nodes.emplace_back();
+            m_resolve(way, pieces.nodes[l].first, pieces.nodes[l].second);
+            nodeRefs = &pieces.nodes[l].second;
+        }
+        pieces.pieces.push_back(WayRows::Piece{&way, nodeRefs, piece.split.first, piece.split.last, link.reversed});
+    }
+    way_rows.write(pieces.pieces.data(), pieces.pieces.size(), split, rows, coordinates, edges);
+}
+
+}  // namespace osm2pgr
@@ -136,7 +136,8 @@ Table::temp_name() const {
     return
         "__" 
         + table_name() 
-        + boost::lexical_cast<std::string>(getpid());
+        + boost::lexical_cast<std::string>(getpid())
+        + m_temp_suffix;
 }
 
 
@@ -177,7 +178,7 @@ Tables::post_process(const Table &table) const  {
         std::string str(
                 " WITH data AS ("
                 " SELECT a.* "
-                " FROM  " + configuration().temp_name() + " a LEFT JOIN  " + configuration().addSchema() + " b USING (tag_id) WHERE (b.tag_id IS NULL))"
+                " FROM  " + table.temp_name() + " a LEFT JOIN  " + configuration().addSchema() + " b USING (tag_id) WHERE (b.tag_id IS NULL))"
 
                 + " INSERT INTO "  +  configuration().addSchema() 
                 + "(" + comma_separated(configuration().columns()) + ") "
@@ -201,7 +202,8 @@ Tables::Tables(const  po::variables_map &vm) :
 
     m_osm_nodes(osm_nodes_config()),
     m_osm_ways(osm_ways_config()),
-    m_osm_relations(osm_relations_config())
+    m_osm_relations(osm_relations_config()),
+    m_ways_pieces(ways_pieces_config())
 {
     auto m_schema(vm["schema"].as<string>());
     m_schema += (m_schema == "" ? "" :  ".");
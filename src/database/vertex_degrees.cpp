@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/vertex_degrees.h"
+
+namespace osm2pgr {
+
+
+VertexDegrees::Degree&
+VertexDegrees::degree(int64_t id) {
+    if (id < m_first) return m_existing[id];
+    auto index = static_cast<size_t>(id - m_first);
+    if (index >= m_added.size()) m_added.resize(index + 1, Degree{0, 0, 0, 0});
+    return m_added[index];
+}
+
+
+const VertexDegrees::Degree&
+VertexDegrees::added(int64_t id) const {
+    static const Degree none{0, 0, 0, 0};
+    auto index = static_cast<size_t>(id - m_first);
+    return id >= m_first && index < m_added.size() ? m_added[index] : none;
+}
+
+
+void
+VertexDegrees::add(int64_t source, int64_t target, bool forward, bool backward,
+        bool zero_length, bool repeated_nodes) {
+    auto chk = zero_length || repeated_nodes ? 1 : 0;
+    if (zero_length) ++m_zero_length;
+    if (repeated_nodes) ++m_repeated_nodes;
+
+    auto &from = degree(source);
+    ++from.cnt;
+    if (forward) ++from.eout;
+    if (backward) ++from.ein;
+    if (chk) from.chk = chk;
+
+    auto &to = degree(target);
+    ++to.cnt;
+    if (forward) ++to.ein;
+    if (backward) ++to.eout;
+    if (chk) to.chk = chk;
+}
+
+
+/*
+ * the vertices of the table are left out: their counts are the ones of this run only
+ */
+void
+VertexDegrees::print(std::ostream &out) const {
+    size_t dead_ends = 0;
+    size_t no_way_out = 0;
+    size_t no_way_in = 0;
+    size_t checked = 0;
+    for (const auto &degree : m_added) {
+        if (degree.cnt == 1) ++dead_ends;
+        if (degree.eout == 0) ++no_way_out;
+        if (degree.ein == 0) ++no_way_in;
+        if (degree.chk) ++checked;
+    }
+
+    out << "    Vertices analyzed: " << m_added.size() << ", "
+        << dead_ends << " dead ends (cnt = 1), "
+        << no_way_out << " can not be left (eout = 0), "
+        << no_way_in << " can not be reached (ein = 0)\n"
+        << "    Rows flagged (chk = 1 on their vertices: " << checked << "): "
+        << m_zero_length << " of zero length, "
+        << m_repeated_nodes << " with repeated nodes\n";
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/way_chains.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace osm2pgr {
+
+
+WayChains::Attributes
+WayChains::Attributes::reversed() const {
+    Attributes attributes(*this);
+    if (one_way == 1 || one_way == -1) attributes.one_way = -one_way;
+    std::swap(attributes.maxspeed_forward, attributes.maxspeed_backward);
+    return attributes;
+}
+
+
+bool
+WayChains::Attributes::operator==(const Attributes &other) const {
+    return tag_id == other.tag_id
+        && one_way == other.one_way
+        && maxspeed_forward == other.maxspeed_forward
+        && maxspeed_backward == other.maxspeed_backward;
+}
+
+
+/*
+ * the maxspeeds of the configuration when the way has none, as in the rows
+ */
+WayChains::Attributes
+WayChains::attributes(const Way &way, const WayRows::Split &split) {
+    Attributes attributes;
+    attributes.tag_id = split.tag->tag_id;
+    attributes.one_way = way.oneWayType();
+    attributes.maxspeed_forward = way.maxspeed_forward() == -1 ?
+        split.tag->maxspeed_forward : way.maxspeed_forward();
+    attributes.maxspeed_backward = way.maxspeed_backward() == -1 ?
+        split.tag->maxspeed_backward : way.maxspeed_backward();
+    return attributes;
+}
+
+
+void
+WayChains::add(int64_t source_osm, int64_t target_osm, const Attributes &attributes) {
+    m_splits.push_back(Split{{source_osm, target_osm}, attributes});
+}
+
+
+/*
+ * Arriving at the vertex by one split and leaving by the other, both
+ * walked in the direction of the chain, the attributes are the same
+ */
+bool
+WayChains::removable(int64_t node, const Vertex &vertex, const std::function<bool(int64_t)> &fixed) const {
+    if (vertex.degree != 2 || vertex.split[0] == vertex.split[1] || fixed(node)) return false;
+    const auto &in = m_splits[vertex.split[0]].attributes;
+    const auto &out = m_splits[vertex.split[1]].attributes;
+    /* arriving by its first node: the split is walked reversed; leaving by its last node, the same */
+    return (vertex.end[0] == 0 ? in.reversed() : in) == (vertex.end[1] == 1 ? out.reversed() : out);
+}
+
+
+bool
+WayChains::next(const Link &link, Link &next) const {
+    const auto &vertex = m_vertices.at(m_splits[link.split].node[link.reversed ? 0 : 1]);
+    if (!vertex.removable) return false;
+    auto k = other(vertex, link.split);
+    next.split = vertex.split[k];
+    next.reversed = vertex.end[k] == 1;
+    return true;
+}
+
+
+bool
+WayChains::previous(const Link &link, Link &previous) const {
+    const auto &vertex = m_vertices.at(m_splits[link.split].node[link.reversed ? 1 : 0]);
+    if (!vertex.removable) return false;
+    auto k = other(vertex, link.split);
+    previous.split = vertex.split[k];
+    previous.reversed = vertex.end[k] == 0;
+    return true;
+}
+
+
+void
+WayChains::build(const std::function<bool(int64_t)> &fixed) {
+    m_vertices.reserve(m_splits.size());
+    for (size_t i = 0; i < m_splits.size(); ++i) {
+        for (int end = 0; end < 2; ++end) {
+            auto &vertex = m_vertices.emplace(m_splits[i].node[end], Vertex{0, false, {0, 0}, {0, 0}}).first->second;
+            if (vertex.degree < 2) {
+                vertex.split[vertex.degree] = i;
+                vertex.end[vertex.degree] = end;
+            }
+            ++vertex.degree;
+        }
+    }
+    for (auto &vertex : m_vertices) vertex.second.removable = removable(vertex.first, vertex.second, fixed);
+
+    /*
+     * each split not in a chain yet: back to the start of its chain, then
+     * the chain; walking back to the split itself, the chain is closed
+     */
+    std::vector<bool> used(m_splits.size(), false);
+    m_links.reserve(m_splits.size());
+    m_chains.assign(1, 0);
+    for (size_t i = 0; i < m_splits.size(); ++i) {
+        if (used[i]) continue;
+        Link first{i, false};
+        Link link;
+        while (previous(first, link)) {
+            if (link.split == i) {
+                first = Link{i, false};
+                break;
+            }
+            first = link;
+        }
+
+        auto begin = m_links.size();
+        link = first;
+        Link following;
+        for (;;) {
+            m_links.push_back(link);
+            used[link.split] = true;
+            if (!next(link, following) || following.split == first.split) break;
+            link = following;
+        }
+
+        /* the first split in its own direction */
+        if (m_links[begin].reversed) {
+            std::reverse(m_links.begin() + static_cast<std::ptrdiff_t>(begin), m_links.end());
+            for (auto l = begin; l < m_links.size(); ++l) m_links[l].reversed = !m_links[l].reversed;
+        }
+        m_removed += m_links.size() - begin - 1;
+        m_chains.push_back(m_links.size());
+    }
+
+    std::vector<Split>().swap(m_splits);
+    std::unordered_map<int64_t, Vertex>().swap(m_vertices);
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,179 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/way_copy.h"
+
+namespace osm2pgr {
+
+//! ways (or chains) in a batch written by the pool
+static const size_t batch_size = 256;
+
+
+WayCopy::WayCopy(
+        const std::vector<Way> &ways,
+        const Resolver &resolve,
+        WayRows &way_rows,
+        VertexDegrees &degrees,
+        const KeptSplits *chains,
+        bool binary,
+        size_t split_threads,
+        bool csr) :
+    m_ways(ways),
+    m_resolve(resolve),
+    m_way_rows(way_rows),
+    m_degrees(degrees),
+    m_chains(chains),
+    m_binary(binary),
+    m_csr(csr),
+    m_count(0),
+    m_split_count(0),
+    m_piece_rows(binary),
+    m_piece_count(0) {
+    m_piece_rows.header();
+    if (split_threads != 1) m_pool.reset(new ThreadPool(split_threads));
+}
+
+
+void
+WayCopy::add_degrees(const Way &way, const WayRows::Split &split) {
+    m_degrees.add(split.source, split.target, !way.is_reversed(), !way.is_oneway(),
+            split.zero_length, split.repeated_nodes);
+}
+
+
+size_t
+WayCopy::number(size_t i, const std::vector<Node*> &nodeRefs, std::vector<WayRows::Split> &splits) {
+    auto begin = splits.size();
+    auto count = m_way_rows.number(m_ways[i], nodeRefs, splits);
+    for (auto s = begin; s < splits.size(); ++s) add_degrees(m_ways[i], splits[s]);
+    return count;
+}
+
+
+void
+WayCopy::number(size_t i, std::vector<WayRows::Split> &splits) {
+    m_chains->number(i, m_way_rows, splits);
+    const auto &split = splits.back();
+    add_degrees(m_chains->way(i), split);
+    if (m_chains->contracted()) m_piece_count += m_chains->pieces(i, split, m_piece_rows);
+}
+
+
+CopyBuffer
+WayCopy::write(Batch &batch) const {
+    CopyBuffer rows(m_binary);
+    WayRows::Coordinates coordinates;
+    std::vector<Node> nodes;
+    std::vector<Node*> refs;
+    KeptSplits::Pieces pieces;
+    auto edges = m_csr ? &batch.edges : nullptr;
+    const auto *split = batch.splits.data();
+    for (const auto &way_splits : batch.ways) {
+        if (m_chains) {
+            m_chains->write(way_splits.first, *split++, m_way_rows, rows, coordinates, pieces, edges);
+            continue;
+        }
+        const auto &way = m_ways[way_splits.first];
+        const auto *nodeRefs = &way.nodeRefs();
+        if (m_resolve) {
+            m_resolve(way, nodes, refs);
+            nodeRefs = &refs;
+        }
+        m_way_rows.write(way, *nodeRefs, split, way_splits.second, rows, coordinates, edges);
+        split += way_splits.second;
+    }
+    return rows;
+}
+
+
+void
+WayCopy::append_front(CopyBuffer &rows) {
+    rows.append(m_pending.front().second.get());
+    const auto &edges = m_pending.front().first->edges;
+    m_edges.insert(m_edges.end(), edges.begin(), edges.end());
+    m_pending.pop_front();
+}
+
+
+bool
+WayCopy::copy(CopyBuffer &rows, size_t start, size_t limit, const Sink &send) {
+    auto edges = m_csr ? &m_edges : nullptr;
+    bool sent = true;
+    std::shared_ptr<Batch> batch;
+    for (auto i = start; sent && i < limit; ++i) {
+        ++m_count;
+
+        if (m_chains) {
+            m_splits.clear();
+            number(i, m_splits);
+            ++m_split_count;
+            if (!m_pool) {
+                m_chains->write(i, m_splits[0], m_way_rows, rows, m_coordinates, m_pieces, edges);
+                if (send) sent = send(rows);
+                continue;
+            }
+            if (!batch) batch = std::make_shared<Batch>();
+            batch->splits.push_back(m_splits[0]);
+            batch->ways.emplace_back(i, 1);
+        } else if (m_ways[i].is_tag_configured()) {
+            const auto &way = m_ways[i];
+            const auto *nodeRefs = &way.nodeRefs();
+            if (m_resolve) {
+                m_resolve(way, m_nodes, m_refs);
+                nodeRefs = &m_refs;
+            }
+
+            if (!m_pool) {
+                m_splits.clear();
+                auto splits = number(i, *nodeRefs, m_splits);
+                m_way_rows.write(way, *nodeRefs, m_splits.data(), splits, rows, m_coordinates, edges);
+                m_split_count += splits;
+                if (send) sent = send(rows);
+                continue;
+            }
+
+            if (!batch) batch = std::make_shared<Batch>();
+            auto splits = number(i, *nodeRefs, batch->splits);
+            if (splits) batch->ways.emplace_back(i, splits);
+            m_split_count += splits;
+        }
+
+        if (batch && (batch->ways.size() == batch_size || i + 1 == limit)) {
+            m_pending.emplace_back(batch, m_pool->submit([this, batch]() {return write(*batch);}));
+            batch.reset();
+            while (sent && m_pending.size() >= 2 * m_pool->size()) {
+                append_front(rows);
+                if (send) sent = send(rows);
+            }
+        }
+    }
+    while (sent && !m_pending.empty()) {
+        append_front(rows);
+        if (send) sent = send(rows);
+    }
+    /* the batches written for nothing */
+    for (; !m_pending.empty(); m_pending.pop_front()) m_pending.front().second.wait();
+    return sent;
+}
+
+}  // namespace osm2pgr
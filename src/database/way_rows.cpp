@@ -0,0 +1,272 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "database/way_rows.h"
+
+#include <cstdint>
+#include <string>
+
+#include "utilities/geodesic.h"
+
+namespace osm2pgr {
+
+
+const WayRows::Tag_columns&
+WayRows::tag_columns(const Tag &tag) {
+    const auto &tag_value = m_config.tag_value(tag);
+    auto found = m_tags.find(&tag_value);
+    if (found != m_tags.end()) return found->second;
+
+    Tag_columns columns;
+    columns.tag_id = static_cast<int32_t>(tag_value.id());
+    columns.maxspeed_forward = m_config.maxspeed_forward(tag);
+    columns.maxspeed_backward = m_config.maxspeed_backward(tag);
+    columns.priority = m_config.priority(tag);
+    return m_tags[&tag_value] = columns;
+}
+
+
+size_t
+WayRows::add(
+        const Way &way,
+        const std::vector<Node*> &nodeRefs,
+        CopyBuffer &rows) {
+    m_splits.clear();
+    auto splits = number(way, nodeRefs, m_splits);
+    write(way, nodeRefs, m_splits.data(), splits, rows, m_coordinates);
+    return splits;
+}
+
+
+size_t
+WayRows::number(
+        const Way &way,
+        const std::vector<Node*> &nodeRefs,
+        std::vector<Split> &splits) {
+    auto begin = splits.size();
+    auto count = keep(way, nodeRefs, splits);
+    for (auto i = begin; i < splits.size(); ++i) number(splits[i], nodeRefs);
+    return count;
+}
+
+
+size_t
+WayRows::keep(
+        const Way &way,
+        const std::vector<Node*> &nodeRefs,
+        std::vector<Split> &splits) {
+    const auto &tag = tag_columns(way.tag_config());
+
+    size_t count = 0;
+    Way::split_bounds(nodeRefs, m_bounds);
+    for (size_t i = 1; i < m_bounds.size(); ++i) {
+        auto first = m_bounds[i - 1];
+        auto last = m_bounds[i];
+        if (!m_edges.insert(way.osm_id(), nodeRefs, first, last)) continue;
+        ++count;
+
+        Split split;
+        split.first = first;
+        split.last = last;
+        split.gid = 0;
+        split.source = 0;
+        split.target = 0;
+        split.tag = &tag;
+        split.component = 0;
+        split.zero_length = true;
+        split.repeated_nodes = false;
+        for (auto j = first + 1; j <= last; ++j) {
+            const auto &node = *nodeRefs[j];
+            const auto &previous = *nodeRefs[j - 1];
+            if (node.osm_id() == previous.osm_id()) split.repeated_nodes = true;
+            if (node.lon_e7() != nodeRefs[first]->lon_e7() || node.lat_e7() != nodeRefs[first]->lat_e7()) {
+                split.zero_length = false;
+            }
+        }
+        splits.push_back(split);
+    }
+    return count;
+}
+
+
+void
+WayRows::number(Split &split, const std::vector<Node*> &nodeRefs) {
+    number(split, *nodeRefs[split.first], *nodeRefs[split.last]);
+}
+
+
+void
+WayRows::number(Split &split, const Node &source, const Node &target) {
+    split.gid = ++m_gid;
+    split.source = m_vertices.id(source);
+    split.target = m_vertices.id(target);
+}
+
+
+void
+WayRows::write(
+        const Way &way,
+        const std::vector<Node*> &nodeRefs,
+        const Split *splits, size_t count,
+        CopyBuffer &rows,
+        Coordinates &coordinates,
+        std::vector<CsrGraph::Edge> *edges) const {
+    auto &lon = coordinates.lon;
+    auto &lat = coordinates.lat;
+    for (const auto *split = splits; split != splits + count; ++split) {
+        auto first = split->first;
+        auto last = split->last;
+
+        double length = 0;
+        for (auto j = first + 1; j <= last; ++j) {
+            length += nodeRefs[j]->getLength(*nodeRefs[j - 1]);
+        }
+
+        lon.clear();
+        lat.clear();
+        for (auto j = first; j <= last; ++j) {
+            lon.push_back(nodeRefs[j]->lon_e7());
+            lat.push_back(nodeRefs[j]->lat_e7());
+        }
+        write_row(way, *split, *nodeRefs[first], *nodeRefs[last], length, coordinates, rows, edges);
+    }
+}
+
+
+/*
+ * the nodes of the pieces one after the other, the node shared by two
+ * pieces once
+ */
+void
+WayRows::write(
+        const Piece *pieces, size_t count,
+        const Split &split,
+        CopyBuffer &rows,
+        Coordinates &coordinates,
+        std::vector<CsrGraph::Edge> *edges) const {
+    if (count == 0) return;
+
+    auto &lon = coordinates.lon;
+    auto &lat = coordinates.lat;
+    lon.clear();
+    lat.clear();
+    double length = 0;
+    const Node *source = nullptr;
+    const Node *previous = nullptr;
+    for (const auto *piece = pieces; piece != pieces + count; ++piece) {
+        const auto &nodeRefs = *piece->nodeRefs;
+        auto nodes = piece->last - piece->first + 1;
+        for (size_t k = (piece == pieces ? 0 : 1); k < nodes; ++k) {
+            const auto *node = nodeRefs[piece->reversed ? piece->last - k : piece->first + k];
+            if (previous) length += node->getLength(*previous);
+            if (!source) source = node;
+            lon.push_back(node->lon_e7());
+            lat.push_back(node->lat_e7());
+            previous = node;
+        }
+    }
+    write_row(*pieces[0].way, split, *source, *previous, length, coordinates, rows, edges);
+}
+
+
+/*
+ * the columns of ways_config, in the same order
+ */
+void
+WayRows::write_row(
+        const Way &way,
+        const Split &split,
+        const Node &source, const Node &target,
+        double length,
+        const Coordinates &coordinates,
+        CopyBuffer &rows,
+        std::vector<CsrGraph::Edge> *edges) const {
+    const auto &tag = *split.tag;
+    auto maxspeed_forward = way.maxspeed_forward() == -1 ?
+        tag.maxspeed_forward : way.maxspeed_forward();
+    auto maxspeed_backward = way.maxspeed_backward() == -1 ?
+        tag.maxspeed_backward : way.maxspeed_backward();
+    auto name = way.tags().find("name");
+
+    const auto &lon = coordinates.lon;
+    const auto &lat = coordinates.lat;
+    auto length_m = geodesic_length(lon.data(), lat.data(), lon.size());
+
+    rows.row(m_components ? 25 : 24);
+    rows.int8(split.gid);
+    rows.int4(tag.tag_id);
+    rows.int8(way.osm_id());
+    rows.float8(maxspeed_forward);
+    rows.float8(maxspeed_backward);
+    rows.int4(way.oneWayType());
+    rows.text(way.oneWay());
+    rows.float8(tag.priority);
+
+    rows.float8(length);
+    rows.float8(length_m);
+    rows.degrees(source.lon_e7());
+    rows.degrees(source.lat_e7());
+    rows.degrees(target.lon_e7());
+    rows.degrees(target.lat_e7());
+    rows.int8(source.osm_id());
+    rows.int8(target.osm_id());
+    rows.int8(split.source);
+    rows.int8(split.target);
+
+    rows.linestring(lon.size());
+    for (size_t j = 0; j < lon.size(); ++j) {
+        rows.coordinate(lon[j], lat[j]);
+    }
+
+    // cost based on oneway
+    auto cost = way.is_reversed() ? -length : length;
+    rows.float8(cost);
+    // reverse_cost
+    auto reverse_cost = way.is_oneway() ? -length : length;
+    rows.float8(reverse_cost);
+    if (edges) {
+        edges->push_back(CsrGraph::Edge{split.gid, split.source, split.target, cost, reverse_cost,
+                source.lon_e7(), source.lat_e7(), target.lon_e7(), target.lat_e7()});
+    }
+
+    // travel time: the speeds are in km/h
+    if (maxspeed_forward != 0 && maxspeed_backward != 0) {
+        auto cost_s = length_m / (maxspeed_forward * 5.0 / 18.0);
+        auto reverse_cost_s = length_m / (maxspeed_backward * 5.0 / 18.0);
+        rows.float8(way.is_reversed() ? -cost_s : cost_s);
+        rows.float8(way.is_oneway() ? -reverse_cost_s : reverse_cost_s);
+    } else {
+        rows.null();
+        rows.null();
+    }
+
+    if (name == way.tags().end()) {
+        rows.null();
+    } else {
+        rows.text(name->second);
+    }
+
+    if (m_components) rows.int8(split.component);
+}
+
+}  // namespace osm2pgr
@@ -75,6 +75,7 @@ Tables::ways_config() const {
                 ", maxspeed_forward double precision"
                 ", maxspeed_backward double precision"
                 ", priority double precision DEFAULT 1"
+                ", component bigint"
 #if 0
                 + (m_vm.count("attributes") ?
                         (std::string(", attributes ") + (m_vm.count("hstore") ? "hstore" : "json"))
@@ -93,6 +94,7 @@ Tables::ways_config() const {
 
 
     std::vector<std::string> columns;
+    columns.push_back("gid");
     columns.push_back("tag_id");
     columns.push_back("osm_id");
     columns.push_back("maxspeed_forward");
@@ -102,14 +104,23 @@ Tables::ways_config() const {
     columns.push_back("priority");
 
     columns.push_back("length");
+    columns.push_back("length_m");
     columns.push_back("x1"); columns.push_back("y1");
     columns.push_back("x2"); columns.push_back("y2");
     columns.push_back("source_osm");
     columns.push_back("target_osm");
+    columns.push_back("source");
+    columns.push_back("target");
     columns.push_back("the_geom");
     columns.push_back("cost");
     columns.push_back("reverse_cost");
+    columns.push_back("cost_s");
+    columns.push_back("reverse_cost_s");
     columns.push_back("name");
+    /* --components, --prune */
+    if (m_vm.count("components") || (m_vm.count("prune") && m_vm["prune"].as<std::size_t>() > 0)) {
+        columns.push_back("component");
+    }
 
 
 #if 0
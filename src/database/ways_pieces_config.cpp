@@ -0,0 +1,76 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2017 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+#include "database/table_management.h"
+#include <string>
+
+namespace osm2pgr {
+
+
+/*
+ * configuring TABLE ways_pieces: the split ways of each row of ways (--contract)
+ */
+
+
+Table
+Tables::ways_pieces_config() const {
+    Table table(
+            /* name */
+            "ways_pieces",
+
+            /* schema */
+            m_vm["schema"].as<std::string>(),
+
+            /* full name */
+            std::string(
+                m_vm["prefix"].as<std::string>()
+                + "ways"
+                + m_vm["suffix"].as<std::string>()
+                + "_pieces"),
+
+            /* standard column creation string */
+            std::string(
+                " gid bigint"
+                ", seq integer"
+                ", osm_id bigint"
+                ", source_osm bigint"
+                ", target_osm bigint"
+                ", reversed boolean"),
+
+            /* other columns */
+            "",
+
+            /* geometry */
+            "");
+
+    std::vector<std::string> columns;
+    columns.push_back("gid");
+    columns.push_back("seq");
+    columns.push_back("osm_id");
+    columns.push_back("source_osm");
+    columns.push_back("target_osm");
+    columns.push_back("reversed");
+    table.set_columns(columns);
+
+    return table;
+}
+
+
+} //namespace osm2pgr
@@ -56,6 +56,7 @@ Tables::ways_vertices_pgr_config() const {
                 ", cnt integer"
                 ", chk integer"
                 ", ein integer"
+                ", component bigint"
 #if 0
                 + (m_vm.count("attributes") ?
                     (std::string(", attributes ") + (m_vm.count("hstore") ? "hstore" : "json"))
@@ -72,7 +73,23 @@ Tables::ways_vertices_pgr_config() const {
                 /* geometry */
                 "POINT");
 
-            return table;
+    std::vector<std::string> columns;
+    columns.push_back("id");
+    columns.push_back("osm_id");
+    columns.push_back("lon");
+    columns.push_back("lat");
+    columns.push_back("the_geom");
+    columns.push_back("cnt");
+    columns.push_back("chk");
+    columns.push_back("ein");
+    columns.push_back("eout");
+    /* --components, --prune */
+    if (m_vm.count("components") || (m_vm.count("prune") && m_vm["prune"].as<std::size_t>() > 0)) {
+        columns.push_back("component");
+    }
+    table.set_columns(columns);
+
+    return table;
 }
 
 
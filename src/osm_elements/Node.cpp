@@ -24,37 +24,166 @@
 #include <boost/geometry/geometries/point_xy.hpp>
 #endif
 
+#include <string.h>
 #include <boost/lexical_cast.hpp>
 #include <map>
-#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
 #include <math.h>
 #include "osm_elements/osm_tag.h"
 #include "osm_elements/Node.h"
+#include "utilities/copy_buffer.h"
 
 namespace osm2pgr {
 
 
-Node::Node(const char **atts) :
-    Element(atts),
-    m_numsOfUse(0) {
-        assert(has_attribute("lat"));
-        assert(has_attribute("lon"));
+/*
+ * decimal degrees to 1e-7 fixed point
+ */
+static
+int32_t
+fixed_point(const char *value) {
+    return static_cast<int32_t>(std::lround(std::strtod(value, NULL) * 1e7));
+}
+
+
+Node::Node(const char **atts, bool keep_attributes) :
+    m_osm_id(0),
+    m_lat(0),
+    m_lon(0),
+    m_numsOfUse(0),
+    m_located(false) {
+        bool has_lat(false);
+        bool has_lon(false);
+        for (auto attribut = atts; *attribut != NULL; attribut += 2) {
+            if (strcmp(attribut[0], "id") == 0) {
+                m_osm_id = std::strtoll(attribut[1], NULL, 10);
+            } else if (strcmp(attribut[0], "lat") == 0) {
+                m_lat = fixed_point(attribut[1]);
+                has_lat = true;
+            } else if (strcmp(attribut[0], "lon") == 0) {
+                m_lon = fixed_point(attribut[1]);
+                has_lon = true;
+            }
+        }
+        m_located = has_lat && has_lon;
+        if (keep_attributes) m_extra.reset(new Element(atts));
+    }
+
+
+Node::Node(const Node &other) :
+    m_osm_id(other.m_osm_id),
+    m_lat(other.m_lat),
+    m_lon(other.m_lon),
+    m_numsOfUse(other.m_numsOfUse),
+    m_located(other.m_located),
+    m_extra(other.m_extra ? new Element(*other.m_extra) : nullptr) {
+}
+
+
+Node&
+Node::operator=(const Node &other) {
+    if (this != &other) {
+        m_osm_id = other.m_osm_id;
+        m_lat = other.m_lat;
+        m_lon = other.m_lon;
+        m_numsOfUse = other.m_numsOfUse;
+        m_located = other.m_located;
+        m_extra.reset(other.m_extra ? new Element(*other.m_extra) : nullptr);
     }
+    return *this;
+}
+
+
+Element&
+Node::extra() {
+    if (!m_extra) m_extra.reset(new Element(m_osm_id));
+    return *m_extra;
+}
+
+
+Tag
+Node::add_tag(const Tag &tag) {
+    return extra().add_tag(tag);
+}
 
-void 
+
+const std::map<std::string, std::string>&
+Node::tags() const {
+    static const std::map<std::string, std::string> no_tags;
+    return m_extra ? m_extra->tags() : no_tags;
+}
+
+
+void
 Node::tag_config(const Tag &tag) {
-    Element::tag_config(tag);
+    extra().tag_config(tag);
     ++m_numsOfUse;
     ++m_numsOfUse;
 }
 
 
+std::string
+Node::fixed_str(int32_t value) {
+    char buffer[16];
+    auto magnitude = value < 0 ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    auto len = snprintf(buffer, sizeof(buffer), "%s%ld.%07ld",
+            value < 0 ? "-" : "",
+            static_cast<long>(magnitude / 10000000),
+            static_cast<long>(magnitude % 10000000));
+    while (buffer[len - 1] == '0') --len;
+    if (buffer[len - 1] == '.') --len;
+    return std::string(buffer, static_cast<size_t>(len));
+}
+
+
+std::vector<std::string>
+Node::values(const std::vector<std::string> &columns, bool is_hstore) const {
+    std::vector<std::string> values;
+    if (m_extra) {
+        values = m_extra->values(columns, is_hstore);
+    } else {
+        values.resize(columns.size());
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i] == "the_geom") {
+            values[i] = get_geometry();
+        } else if (columns[i] == "osm_id") {
+            values[i] = osm_id_str();
+        }
+    }
+    return values;
+}
+
+
+void
+Node::copy_values(
+        const std::vector<std::string> &columns,
+        CopyBuffer &row) const {
+    row.row(columns.size());
+    for (const auto &column : columns) {
+        if (column == "the_geom") {
+            row.point(m_lon, m_lat);
+        } else if (column == "osm_id") {
+            row.int8(m_osm_id);
+        } else if (m_extra) {
+            m_extra->copy_value(column, row);
+        } else {
+            row.null();
+        }
+    }
+}
+
+
 double
 Node::getLength(const Node &previous) const {
-    auto y1 = boost::lexical_cast<double>(get_attribute("lat"));
-    auto x1 = boost::lexical_cast<double>(get_attribute("lon"));
-    auto y2 = boost::lexical_cast<double>(previous.get_attribute("lat"));
-    auto x2 = boost::lexical_cast<double>(previous.get_attribute("lon"));
+    auto y1 = latitude();
+    auto x1 = longitude();
+    auto y2 = previous.latitude();
+    auto x2 = previous.longitude();
     return sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2));
 #if 0
     typedef boost::geometry::model::d2::point_xy<double> point_type;
@@ -62,13 +191,9 @@ Node::getLength(const Node &previous) const {
     /* converted point to fit boost.geomtery
      *      * (`p` and `q` are same as `a ` and `b`)
      *           */
-    point_type p(
-            boost::lexical_cast<double>(get_attribute("lat")),
-            boost::lexical_cast<double>(get_attribute("lon")));
+    point_type p(latitude(), longitude());
 
-    point_type q(
-            boost::lexical_cast<double>(previous.get_attribute("lat")),
-            boost::lexical_cast<double>(previous.get_attribute("lon")));
+    point_type q(previous.latitude(), previous.longitude());
 
     return boost::geometry::distance(p, q);
 #endif
@@ -28,10 +28,6 @@
 #include <iostream>
 #include <algorithm>
 
-#if 0
-#include <sys/wait.h>
-#endif
-
 #include "utilities/utilities.h"
 #include "configuration/configuration.h"
 #include "osm_elements/Node.h"
@@ -44,56 +40,67 @@ namespace osm2pgr {
 OSMDocument::OSMDocument(
         const Configuration &config,
         const po::variables_map &vm,
-        const Export2DB &db_conn,
-        size_t lines) :
+        const Export2DB &db_conn) :
+    m_node_index(NodeIndex::create(vm["node-index"].as<std::string>())),
     m_relPending(false),
     m_waysPending(true),
     m_rConfig(config),
     m_vm(vm),
     m_db_conn(db_conn),
+    m_kept_nodes(nullptr),
+    m_flat_nodes(nullptr),
     m_chunk_size(vm["chunk"].as<size_t>()),
     m_nodeErrs(0),
-    m_lines(lines) {
+    m_unlocated(0) {
+    auto writers = vm["writer-threads"].as<size_t>();
+    if (vm.count("addnodes") && writers) {
+        /* two chunks per writer are waiting at most */
+        m_exports.reset(new ExportQueue(writers, 2 * writers));
+    }
 }
 
 
-void
-OSMDocument::wait_child() const {
-#if 0
-    while (true) {
-        int status;
-        pid_t done = wait(&status);
-        if (done == -1) {
-            if (errno == ECHILD) break; // no more child processes
-        } else {
-            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
-                cerr << "pid " << done << " failed" << endl;
-                exit(1);
-            }
-        }
-    }
-#endif
+bool
+OSMDocument::keep_node(const Node &node) const {
+    return !m_kept_nodes
+        || m_kept_nodes->has(node.osm_id())
+        || (m_vm.count("addnodes") && node.has_tags());
 }
 
 
 void
-OSMDocument::AddNode(const Node &n) {
+OSMDocument::AddNode(Node n) {
+    /* not at (0, 0): the ways using it count it as missing */
+    if (!n.located()) {
+        ++m_unlocated;
+        return;
+    }
+    if (m_flat_nodes) {
+        /* the negative ids (JOSM) are kept in memory only: set on every run */
+        if (!m_flat_nodes->reused() || n.osm_id() < 0) m_flat_nodes->set(n.osm_id(), n.lat_e7(), n.lon_e7());
+        /* osm_nodes gets all the nodes, as without the file */
+        if (!n.has_tags() && !m_vm.count("addnodes")) return;
+    }
+    if (!keep_node(n)) return;
+
     if (m_vm.count("addnodes")) {
         if ((m_nodes.size() % m_chunk_size) == 0) {
-            wait_child();
             std::cout << "\rCurrent osm_nodes:\t" << m_nodes.size();
             osm_table_export(m_nodes, "osm_nodes");
             export_pois();
         }
     }
 
-    m_nodes.push_back(n);
+    m_node_index->add(n.osm_id(), m_nodes.size());
+    m_nodes.push_back(std::move(n));
 }
 
 void 
-OSMDocument::AddWay(const Way &w) {
+OSMDocument::AddWay(Way w) {
+    /* the files have the nodes first */
+    if (m_ways.empty()) m_node_index->finish();
+
     if (m_ways.empty() && m_vm.count("addnodes")) {
-        wait_child();
         osm_table_export(m_nodes, "osm_nodes");
         export_pois();
         std::cout << "\nFinal osm_nodes:\t" << m_nodes.size() << "\n";
@@ -102,13 +109,12 @@ OSMDocument::AddWay(const Way &w) {
 
     if (m_vm.count("addnodes")) {
         if ((m_ways.size() % m_chunk_size) == 0) {
-            wait_child();
             std::cout << "\rCurrent osm_ways:\t" << m_ways.size();
             osm_table_export(m_ways, "osm_ways");
         }
     }
 
-    m_ways.push_back(w);
+    m_ways.push_back(std::move(w));
 }
 
 void
@@ -117,7 +123,6 @@ OSMDocument::AddRelation(const Relation &r) {
     m_relations.push_back(r);
     if (m_vm.count("addnodes")) {
         if (m_relations.size() % m_chunk_size == 0) {
-            wait_child();
             std::cout << "Current osm_relations:\t" << m_relations.size();
             osm_table_export(m_relations, "osm_relations");
             m_relPending = false;
@@ -127,25 +132,46 @@ OSMDocument::AddRelation(const Relation &r) {
 
 void
 OSMDocument::endOfFile() {
+    /* before the ways are resolved on the --split-threads pool */
+    m_node_index->finish();
     
     if (m_vm.count("addnodes") && m_waysPending) {
         m_waysPending = false;
-        wait_child();
         osm_table_export(m_ways, "osm_ways");
         std::cout << "\nFinal osm_ways:\t\t" << m_ways.size();
     }
     
     if (m_vm.count("addnodes") && m_relPending) {
         m_relPending = false;
-        wait_child();
         std::cout << "\nFinal osm_relations:\t" << m_relations.size() << "\n";
         osm_table_export(m_relations, "osm_relations");
     }
-    
+
+    finish_exports();
     std::cout << "\nEnd Of file\n\n\n";
 }
 
 
+/*
+ * the parser blocked on a full queue: the database is the slow stage,
+ * the writers mostly idle: the parser is
+ */
+void
+OSMDocument::finish_exports() {
+    if (!m_exports) return;
+    m_exports->finish();
+    if (!m_exports->tasks()) return;
+
+    auto writers = static_cast<double>(m_exports->writers());
+    std::cout << "\nosm tables exported: " << m_exports->tasks() << " chunks"
+        << " by " << m_exports->writers() << " writer thread(s)"
+        << " in " << m_exports->elapsed() << " seconds"
+        << "\n    parser waiting on the writers:\t" << m_exports->producer_wait() << " seconds"
+        << "\n    writers busy:\t\t\t" << m_exports->writers_busy() / writers << " seconds (average)"
+        << "\n";
+}
+
+
 template <typename T>
 static
 bool
@@ -156,26 +182,25 @@ less(const T &item, const int64_t &id) {
 
 Node*
 OSMDocument::FindNode(int64_t node_id) {
-    auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), node_id, less<Node>); 
-    return &*it;
+    auto position = m_node_index->find(node_id);
+    return position == NodeIndex::npos ? nullptr : &m_nodes[position];
 }
 
 bool
 OSMDocument::has_node(int64_t node_id) const {
-    auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), node_id, less<Node>); 
-    return (it != m_nodes.end());
+    return m_node_index->find(node_id) != NodeIndex::npos;
 }
 
 Way*
 OSMDocument::FindWay(int64_t way_id) {
     auto it = std::lower_bound(m_ways.begin(), m_ways.end(), way_id, less<Way>); 
-    return &*it;
+    return (it != m_ways.end() && it->osm_id() == way_id) ? &*it : nullptr;
 }
 
 bool
 OSMDocument::has_way(int64_t way_id) const {
     auto it = std::lower_bound(m_ways.begin(), m_ways.end(), way_id, less<Way>); 
-    return (it != m_ways.end());
+    return (it != m_ways.end() && it->osm_id() == way_id);
 }
 
 void
@@ -185,19 +210,57 @@ OSMDocument::add_node(Way &way, const char **atts) {
     std::string value = *attribut++;
     auto node_id =  (key == "ref")?  boost::lexical_cast<int64_t>(value): -1;
     way.add_node(node_id);
+    link_node(way, node_id);
+}
 
+void
+OSMDocument::link_node(Way &way, int64_t node_id) {
 #if 1
+    /*
+     * the node was not kept on purpose: the way is not routable
+     */
+    if (m_kept_nodes && !m_kept_nodes->has(node_id)) return;
+
     // TODO leave this when splitting
-    if (!has_node(node_id)) {
-        ++m_nodeErrs;
-    } else {
-        auto node = FindNode(node_id);
+    auto node = FindNode(node_id);
+    int32_t lat, lon;
+    if (node) {
         node->incrementUse();
-        way.add_node(node);
+        /* flat nodes: all the nodes of the way are linked when exporting */
+        if (!m_flat_nodes) way.add_node(node);
+    } else if (m_flat_nodes && m_flat_nodes->get(node_id, lat, lon)) {
+        m_flat_nodes->add_use(node_id);
+    } else {
+        ++m_nodeErrs;
     }
 #endif
 }
 
+void
+OSMDocument::resolve_nodes(const Way &way, Nodes &nodes, std::vector<Node*> &refs) const {
+    nodes.clear();
+    refs.clear();
+    if (!m_flat_nodes) return;
+
+    for (const auto node_id : way.node_ids()) {
+        if (m_kept_nodes && !m_kept_nodes->has(node_id)) continue;
+        auto position = m_node_index->find(node_id);
+        int32_t lat, lon;
+        if (position != NodeIndex::npos) {
+            /* without the tags, the export only needs the coordinates */
+            const auto &node = m_nodes[position];
+            nodes.push_back(Node(node_id, node.lat_e7(), node.lon_e7()));
+            nodes.back().numsOfUse(node.numsOfUse());
+        } else if (m_flat_nodes->get(node_id, lat, lon)) {
+            nodes.push_back(Node(node_id, lat, lon));
+            nodes.back().numsOfUse(m_flat_nodes->uses(node_id));
+        }
+    }
+    /* once the vector does not grow anymore */
+    for (auto &node : nodes) refs.push_back(&node);
+}
+
+
 /*
  * for example
  *  <tag highway="kerb">
@@ -209,20 +272,30 @@ OSMDocument::add_node(Way &way, const char **atts) {
  *
  */
 
+template <typename T>
+static
 void
-OSMDocument::add_config(Element *item, const Tag &tag) const {
-    auto  k = tag.key();
-    auto  v = tag.value();
-    if (config_has_tag(tag)) {
+set_config(const Configuration &config, T *item, const Tag &tag) {
+    if (config.has_tag(tag)) {
         if (!(item->is_tag_configured())
-                || (config_has_tag(item->tag_config())
-                    && m_rConfig.priority(tag) < m_rConfig.priority(item->tag_config())
+                || (config.has_tag(item->tag_config())
+                    && config.priority(tag) < config.priority(item->tag_config())
                    )) {
             item->tag_config(tag);
         }
     }
 }
 
+void
+OSMDocument::add_config(Element *item, const Tag &tag) const {
+    set_config(m_rConfig, item, tag);
+}
+
+void
+OSMDocument::add_config(Node *node, const Tag &tag) const {
+    set_config(m_rConfig, node, tag);
+}
+
 static
 bool
 has_no_tags(const Node &node) {
@@ -234,41 +307,20 @@ OSMDocument::export_pois() const {
     std::string table("pointsofinterest");
     if (m_nodes.empty()) return;
 
-#if 0
-    if (m_vm.count("fork")) {
-        auto pid = fork();
-        if (pid < 0) {
-            std::cerr << "Failed to fork" << endl;
-            exit(1);
-        }
-        if (pid > 0) return;
-    }
-#endif
-
-
     auto residue = m_nodes.size() % m_chunk_size;
     size_t start = residue? m_nodes.size() - residue : m_nodes.size() - m_chunk_size;
 
-    auto export_items = Nodes(m_nodes.begin() + start, m_nodes.end());
+    auto export_items = std::make_shared<Nodes>(m_nodes.begin() + start, m_nodes.end());
     /*
      * deleting nodes with no tag information
      */
-    export_items.erase(
-            std::remove_if(export_items.begin(), export_items.end(), has_no_tags),
-            export_items.end());
+    export_items->erase(
+            std::remove_if(export_items->begin(), export_items->end(), has_no_tags),
+            export_items->end());
 
-    if (!export_items.empty()) {
-        m_db_conn.export_osm(export_items, table);
+    if (!export_items->empty()) {
+        export_chunk(export_items, table);
     }
-
-#if 0
-    if (m_vm.count("fork")) {
-        /*
-         * finish the child process
-         */
-        _exit(0);
-    }
-#endif
 }
 
 
@@ -79,6 +79,15 @@ Relation::members_str() const {
     return way_list;
 }
 
+std::map<std::string, std::string>
+Relation::members() const {
+    std::map<std::string, std::string> members;
+    for (const auto &way_ref : m_WayRefs) {
+        members[boost::lexical_cast<std::string>(way_ref)] = "type=>way";
+    }
+    return members;
+}
+
 std::ostream& operator<<(std::ostream &os, const Relation &r) {
     os << r.members_str();
     return os;
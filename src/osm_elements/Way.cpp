@@ -30,6 +30,7 @@
 #include "osm_elements/OSMDocument.h"
 #include "osm_elements/osm_tag.h"
 #include "osm_elements/Node.h"
+#include "utilities/copy_buffer.h"
 
 
 
@@ -70,6 +71,11 @@ Way::get_geometry() const {
     return geometry_str(m_NodeRefs);
 }
 
+void
+Way::copy_geometry(CopyBuffer &row) const {
+    copy_geometry(m_NodeRefs, row);
+}
+
 std::string
 Way::length_str() const {
     return length_str(m_NodeRefs);
@@ -95,8 +101,24 @@ Way::geometry_str(const std::vector<Node*> &nodeRefs) const {
 }
 
 
+void
+Way::copy_geometry(const std::vector<Node*> &nodeRefs, CopyBuffer &row) const {
+    /* a single node is an empty linestring, like geometry_str */
+    auto points = nodeRefs.size() < 2 ? 0 : nodeRefs.size();
+    row.linestring(points);
+    for (size_t i = 0; i < points; ++i) {
+        row.coordinate(nodeRefs[i]->lon_e7(), nodeRefs[i]->lat_e7());
+    }
+}
+
+
 std::string
 Way::length_str(const std::vector<Node*> &nodeRefs) const {
+    return boost::lexical_cast<std::string>(length(nodeRefs));
+}
+
+double
+Way::length(const std::vector<Node*> &nodeRefs) const {
     double length = 0;
     auto prev_node_ptr = nodeRefs.front();
 
@@ -109,47 +131,43 @@ Way::length_str(const std::vector<Node*> &nodeRefs) const {
         prev_node_ptr = node_ptr;
     }
 
-    return boost::lexical_cast<std::string>(length);
+    return length;
 }
 
 
 
 std::vector<std::vector<Node*>>
 Way::split_me() {
-    if (nodeRefs().size() < 2) {
-        /*
-         * The way is ill formed
-         */
-        return std::vector<std::vector<Node*>>();
-    }
+    std::vector<size_t> bounds;
+    split_bounds(nodeRefs(), bounds);
 
     std::vector<std::vector<Node*>> m_split_ways;
-    auto it_node(nodeRefs().begin());
-    auto last_node(nodeRefs().end());
+    for (size_t i = 1; i < bounds.size(); ++i) {
+        m_split_ways.push_back(std::vector<Node*>(
+                    nodeRefs().begin() + static_cast<ptrdiff_t>(bounds[i - 1]),
+                    nodeRefs().begin() + static_cast<ptrdiff_t>(bounds[i]) + 1));
+    }
+    return m_split_ways;
+}
 
-    while (it_node != last_node) {
+
+void
+Way::split_bounds(
+        const std::vector<Node*> &nodeRefs,
+        std::vector<size_t> &bounds) {
+    bounds.clear();
+    if (nodeRefs.size() < 2) {
         /*
-         * starting a new split
+         * The way is ill formed
          */
-        std::vector<Node*> split_way;
-        split_way.push_back(*it_node);
-
-        ++it_node;
-
-        if (it_node != last_node) {
-            while (it_node != last_node) {
-                split_way.push_back(*it_node);
-
-                if ((*it_node)->numsOfUse() > 1) {
-                    break;
-                }
-                ++it_node;
-            }
-        }
+        return;
+    }
 
-        if (split_way.size() > 1) m_split_ways.push_back(split_way);
+    bounds.push_back(0);
+    for (size_t i = 1; i + 1 < nodeRefs.size(); ++i) {
+        if (nodeRefs[i]->numsOfUse() > 1) bounds.push_back(i);
     }
-    return m_split_ways;
+    bounds.push_back(nodeRefs.size() - 1);
 }
 
 
@@ -301,12 +319,16 @@ Way::max_speed(const Tag &tag) {
 
 std::string
 Way::oneWayType_str() const {
-    if (m_oneWay == "YES") return "1";
-    if (m_oneWay == "NO") return  "2";
-    if (m_oneWay == "REVERSIBLE") return  "3";
-    if (m_oneWay == "REVERSED") return "-1";
-    if (m_oneWay == "UNKNOWN") return "0";
-    return "0";
+    return boost::lexical_cast<std::string>(oneWayType());
+}
+
+int
+Way::oneWayType() const {
+    if (m_oneWay == "YES") return 1;
+    if (m_oneWay == "NO") return  2;
+    if (m_oneWay == "REVERSIBLE") return  3;
+    if (m_oneWay == "REVERSED") return -1;
+    return 0;
 }
 
 void
@@ -329,6 +351,15 @@ Way::members_str() const {
     return node_list;
 }
 
+std::map<std::string, std::string>
+Way::members() const {
+    std::map<std::string, std::string> members;
+    for (const auto &node_id : m_node_ids) {
+        members[boost::lexical_cast<std::string>(node_id)] = "type=>nd";
+    }
+    return members;
+}
+
 
 
 #ifndef NDEBUG
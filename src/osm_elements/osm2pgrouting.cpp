@@ -24,7 +24,11 @@
 #endif
 
 #include <unistd.h>
+#include <sys/stat.h>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 #include <iostream>
 
 #ifdef WITH_TIME
@@ -32,43 +36,54 @@
 #include <chrono>
 #endif
 
-#include <pqxx/pqxx>
 
 #include "parser/ConfigurationParserCallback.h"
 #include "parser/OSMDocumentParserCallback.h"
+#include "parser/OSMChunkParserCallback.h"
+#include "parser/RoutableNodesParserCallback.h"
+#include "parser/PBFParser.h"
 #include "osm_elements/OSMDocument.h"
 #include "database/Export2DB.h"
 #include "utilities/handle_pgpass.h"
+#include "utilities/id_bitmap.h"
+#include "utilities/flat_nodes.h"
 #include "utilities/prog_options.h"
+#include "utilities/progress.h"
+#include "utilities/thread_pool.h"
 
-#if defined(__linux__)
+/*
+ * .osm.pbf files are read with the PBF parser, anything else is XML
+ */
 static
-size_t lines_in_file(const std::string file_name) {
-    FILE *in;
-    char buff[512];
-    std::string command = "wc -l  " + file_name;
-
-    if (!(in = popen(command.c_str(), "r"))) {
-        std::cerr << "File not found" << file_name << "\n";
-        exit(1);
-    }
+bool
+is_pbf(const std::string &file_name) {
+    const std::string extension(".pbf");
+    return file_name.size() > extension.size()
+        && file_name.compare(file_name.size() - extension.size(), extension.size(), extension) == 0;
+}
 
-    std::string word;
-    if (fgets(buff, 512, in) != NULL) {
-        word = buff;
-    }
-    pclose(in);
-    std::istringstream iss(word);
-    std::string number;
-    iss >> number;
-    try {
-        return boost::lexical_cast<size_t>(number);
-    } catch (...) {
-        std::cerr << "File not found" << file_name << "\n";
-        exit(1);
-    }
+/*
+ * size of the input, 0 when it can not be known (pipes)
+ */
+static
+uint64_t
+file_bytes(const std::string &file_name) {
+    struct stat st;
+    auto ok = file_name == "-" ? fstat(STDIN_FILENO, &st) : stat(file_name.c_str(), &st);
+    if (ok != 0 || !S_ISREG(st.st_mode)) return 0;
+    return static_cast<uint64_t>(st.st_size);
+}
+
+/*
+ * modification time of the input, 0 for pipes
+ */
+static
+int64_t
+file_mtime(const std::string &file_name) {
+    struct stat st;
+    if (file_name == "-" || stat(file_name.c_str(), &st) != 0) return 0;
+    return static_cast<int64_t>(st.st_mtime);
 }
-#endif
 
 
 int main(int argc, char* argv[]) {
@@ -129,29 +144,11 @@ int main(int argc, char* argv[]) {
                     + " dbname=" + vm["dbname"].as<std::string>()
                     + " port=" + vm["port"].as<std::string>()
                     + " password=" + vm["password"].as<std::string>());
-        try {
-            cout << "Testing database connection: "
-                << vm["dbname"].as<std::string>()
-                << endl;
-            pqxx::connection C(connection_str);
-            if (C.is_open()) {
-                cout << "database connection successful: " << C.dbname() << endl;
-            } else {
-                cout << "Can't open database" << endl;
-                return 1;
-            }
-#ifdef PQXX_DISCONNECT
-            C.disconnect ();
-#endif
-        }catch (const std::exception &e){
-            cerr << e.what() << std::endl;
-            return 1;
-        }
 
         /*
-         * preparing the databasse
+         * preparing the databasse, the connection is kept in the pool
          */
-        std::cout << "Connecting to the database"  << endl;
+        std::cout << "Connecting to the database: " << vm["dbname"].as<std::string>() << endl;
         osm2pgr::Export2DB dbConnection(vm, connection_str);
         if (dbConnection.connect() == 1)
             return 1;
@@ -202,29 +199,134 @@ int main(int argc, char* argv[]) {
         std::cout << "  - Done \n";
 
 
-#if defined(__linux__)
-        std::cout << "Counting lines ...\n";
-        auto total_lines = lines_in_file(dataFile);
-        std::cout << "  - Done \n";
-
+        auto total_bytes = file_bytes(dataFile);
         std::cout << "Opening data file: "
             << dataFile
-            << "\ttotal lines: "
-            << total_lines
+            << "\ttotal size: "
+            << static_cast<double>(total_bytes) / (1024.0 * 1024.0) << " MB"
             << endl;
-#else
-        size_t total_lines = 0;
-#endif
-        osm2pgr::OSMDocument document(config, vm, dbConnection, total_lines);
-        osm2pgr::OSMDocumentParserCallback callback(document);
+
+        osm2pgr::OSMDocument document(config, vm, dbConnection);
+        xml::XMLParser data_parser(vm.count("fast-xml") != 0);
+
+        std::unique_ptr<osm2pgr::FlatNodes> flat_nodes;
+        if (vm.count("flat-nodes")) {
+            auto flat_file = vm["flat-nodes"].as<std::string>();
+            flat_nodes.reset(new osm2pgr::FlatNodes(flat_file, total_bytes, file_mtime(dataFile)));
+            document.flat_nodes(*flat_nodes);
+            std::cout << "    Node coordinates in " << flat_file
+                << (flat_nodes->reused() ? " (reused)" : "") << "\n" << endl;
+        }
+
+        /*
+         * first pass: the nodes of the routable ways
+         */
+        osm2pgr::IdBitmap routable_nodes;
+        if (vm.count("two-pass") && dataFile == "-") {
+            std::cout << "    The standard input can not be read twice: importing all the nodes\n";
+        } else if (vm.count("two-pass")) {
+            std::cout << "    Finding the nodes of the routable ways\n" << endl;
+            osm2pgr::ProgressCounters first_progress;
+            osm2pgr::RoutableNodesParserCallback routable(config, routable_nodes, &first_progress);
+            for (int pass = 0; pass < 2; ++pass) {
+                {
+                    osm2pgr::ProgressReporter reporter(first_progress, total_bytes);
+                    if (is_pbf(dataFile)) {
+                        xml::PBFParser pbf_parser;
+                        ret = pbf_parser.Parse(routable, dataFile.c_str(), &first_progress.bytes);
+                    } else {
+                        ret = data_parser.Parse(routable, dataFile.c_str(), &first_progress.bytes);
+                    }
+                }
+                if (ret != 0) {
+                    cerr << "Failed to open / parse data file " << dataFile << endl;
+                    return 1;
+                }
+                /*
+                 * the relations made routable ways that were not:
+                 * once more for their nodes
+                 */
+                if (pass == 1 || routable.promoted().empty()) break;
+                std::cout << "    " << routable.promoted().size() << " ways routable by their relations\n" << endl;
+                routable.promoted_pass();
+                first_progress.bytes = 0;
+                first_progress.elements = 0;
+            }
+            std::cout << "    Keeping " << routable_nodes.size() << " nodes of routable ways ("
+                << static_cast<double>(routable_nodes.memory()) / (1024.0 * 1024.0) << " MB bitmap)\n" << endl;
+            document.keep_nodes(routable_nodes);
+        }
+
+        osm2pgr::ProgressCounters progress;
+        osm2pgr::OSMDocumentParserCallback callback(document, &progress);
 
         std::cout << "    Parsing data\n" << endl;
-        ret = parser.Parse(callback, dataFile.c_str());
+#ifdef WITH_TIME
+        std::chrono::steady_clock::time_point begin_parse =
+            std::chrono::steady_clock::now();
+#endif
+        {
+            osm2pgr::ProgressReporter reporter(progress, total_bytes);
+            auto parse_threads = vm["parse-threads"].as<size_t>();
+            if (parse_threads == 0) parse_threads = osm2pgr::ThreadPool::default_size();
+
+            if (is_pbf(dataFile)) {
+                xml::PBFParser pbf_parser;
+                ret = pbf_parser.Parse(callback, dataFile.c_str(), &progress.bytes);
+            } else if (parse_threads > 1 && dataFile != "-") {
+                /*
+                 * one byte range per thread, merged once all are parsed
+                 */
+                std::vector<std::unique_ptr<osm2pgr::OSMChunkParserCallback>> chunks;
+                std::vector<xml::XMLParserCallback*> chunk_callbacks;
+                for (size_t i = 0; i < parse_threads; ++i) {
+                    chunks.emplace_back(new osm2pgr::OSMChunkParserCallback(document, &progress));
+                    chunk_callbacks.push_back(chunks.back().get());
+                }
+                ret = data_parser.ParseParallel(chunk_callbacks, dataFile.c_str(), &progress.bytes);
+                if (ret == 0) {
+                    osm2pgr::OSMChunkParserCallback::merge(chunks, document);
+                } else if (ret == 3) {
+                    std::cout << "    The input can not be split: parsing on one thread\n";
+                    ret = data_parser.Parse(callback, dataFile.c_str(), &progress.bytes);
+                } else if (ret == 2) {
+                    /* the chunks are dropped: the document was not modified */
+                    std::cout << "    The byte ranges did not parse: parsing on one thread\n";
+                    chunks.clear();
+                    progress.bytes = 0;
+                    progress.elements = 0;
+                    ret = data_parser.Parse(callback, dataFile.c_str(), &progress.bytes);
+                }
+            } else {
+                ret = data_parser.Parse(callback, dataFile.c_str(), &progress.bytes);
+            }
+        }
         if (ret != 0) {
             cerr << "Failed to open / parse data file " << dataFile << endl;
             return 1;
         }
         std::cout << "    Finish Parsing data\n" << endl;
+        if (flat_nodes) flat_nodes->complete();
+        std::cout << "    Node index: " << vm["node-index"].as<std::string>()
+            << ", " << document.node_index().size() << " nodes, "
+            << static_cast<double>(document.node_index().memory()) / (1024.0 * 1024.0) << " MB\n" << endl;
+#ifdef WITH_TIME
+        {
+            /*
+             * throughput of the parsing stage, to compare the XML & PBF inputs
+             */
+            double parse_secs = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - begin_parse).count();
+            auto megabytes = static_cast<double>(progress.bytes) / (1024.0 * 1024.0);
+            std::cout << "Parsing time: " << parse_secs << " seconds, "
+                << megabytes << " MB read"
+                << " (" << (parse_secs > 0 ? megabytes / parse_secs : 0) << " MB/s, "
+                << (is_pbf(dataFile) ? "PBF" : "XML") << " input)\n";
+        }
+#endif
+        if (document.unlocated()) {
+            std::cerr << "******\nNOTICE:  Skipped " << document.unlocated() << " <node ... > without lat or lon\n*****";
+        }
         if (document.nodeErrs()) {
             std::cerr << "******\nNOTICE:  Found " << document.nodeErrs() << " node references with no <node ... >\n*****";
         }
@@ -236,7 +338,19 @@ int main(int argc, char* argv[]) {
 
 
             std::cout << "\nExport Ways ..." << endl;
-            dbConnection.exportWays(document.ways(), config);
+            bool exported;
+            if (flat_nodes) {
+                exported = dbConnection.exportWays(document.ways(), config,
+                        [&document](const osm2pgr::Way &way, osm2pgr::OSMDocument::Nodes &nodes,
+                            std::vector<osm2pgr::Node*> &refs) {
+                        document.resolve_nodes(way, nodes, refs);});
+            } else {
+                exported = dbConnection.exportWays(document.ways(), config);
+            }
+            if (!exported) {
+                cerr << "Failed to export the ways" << endl;
+                return 1;
+            }
 
             if (!no_index) {
                 std::cout << "\nCreating indexes ..." << endl;
@@ -24,6 +24,7 @@
 #include <string>
 #include "osm_elements/osm_tag.h"
 #include "osm_elements/osm_element.h"
+#include "utilities/copy_buffer.h"
 
 namespace osm2pgr {
 
@@ -231,4 +232,48 @@ Element::values(const std::vector<std::string> &columns, bool is_hstore) const {
     return values;
 }
 
+
+
+void
+Element::copy_values(
+        const std::vector<std::string> &columns,
+        CopyBuffer &row) const {
+    row.row(columns.size());
+    for (const auto &column : columns) {
+        copy_value(column, row);
+    }
+}
+
+
+void
+Element::copy_value(const std::string &column, CopyBuffer &row) const {
+    if (column == "osm_id" || column == "tag_id") {
+        row.int8(osm_id());
+    } else if (column == "tag_name") {
+        row.text(m_tag_config.key());
+    } else if (column == "tag_value") {
+        row.text(m_tag_config.value());
+    } else if (column == "the_geom") {
+        copy_geometry(row);
+    } else if (column == "members") {
+        row.hstore(members());
+    } else if (column == "attributes") {
+        row.hstore(m_attributes);
+    } else if (column == "tags") {
+        row.hstore(m_tags);
+    } else if (has_attribute(column)) {
+        row.text(get_attribute(column));
+    } else if (has_tag(column)) {
+        row.text(get_tag(column));
+    } else {
+        row.null();
+    }
+}
+
+
+void
+Element::copy_geometry(CopyBuffer &row) const {
+    row.null();
+}
+
 }  // namespace osm2pgr
@@ -0,0 +1,204 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "parser/OSMChunkParserCallback.h"
+
+#include <string.h>
+#include <boost/lexical_cast.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "parser/OSMDocumentParserCallback.h"
+#include "osm_elements/osm_tag.h"
+#include "osm_elements/Way.h"
+#include "osm_elements/Node.h"
+
+
+namespace osm2pgr {
+
+void
+OSMChunkParserCallback::count_element() {
+    if (m_progress && ((++m_elements & 0xfff) == 0)) {
+        m_progress->elements.fetch_add(0x1000, std::memory_order_relaxed);
+    }
+}
+
+
+void
+OSMChunkParserCallback::StartElement(
+        const char *name,
+        const char** atts) {
+    if (m_current == RELATION || strcmp(name, "relation") == 0) {
+        m_current = RELATION;
+        Recorded element = {true, name, {}};
+        for (auto attribut = atts; *attribut != NULL; ++attribut) {
+            element.atts.push_back(*attribut);
+        }
+        m_relations.push_back(std::move(element));
+        return;
+    }
+
+    if (strcmp(name, "node") == 0) {
+        m_nodes.emplace_back(atts, m_rDocument.node_attributes());
+        m_current = NODE;
+        return;
+    }
+
+    if (strcmp(name, "way") == 0) {
+        m_ways.emplace_back(atts);
+        m_current = WAY;
+        return;
+    }
+
+    if (strcmp(name, "tag") == 0) {
+        if (m_current == NODE) {
+            auto tag = m_nodes.back().add_tag(Tag(atts));
+            m_rDocument.add_config(&m_nodes.back(), tag);
+        }
+        if (m_current == WAY) {
+            auto tag = m_ways.back().add_tag(Tag(atts));
+            m_rDocument.add_config(&m_ways.back(), tag);
+        }
+        return;
+    }
+
+    if (strcmp(name, "nd") == 0 && m_current == WAY) {
+        std::string key = atts[0];
+        std::string value = atts[1];
+        auto node_id = (key == "ref")?  boost::lexical_cast<int64_t>(value): -1;
+        m_ways.back().add_node(node_id);
+    }
+}
+
+
+void
+OSMChunkParserCallback::EndElement(const char* name) {
+    if (strcmp(name, "osm") == 0) {
+        if (m_progress) {
+            m_progress->elements.fetch_add(m_elements & 0xfff, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (m_current == RELATION) {
+        m_relations.push_back(Recorded{false, name, {}});
+        if (strcmp(name, "relation") == 0) {
+            m_current = NONE;
+            count_element();
+        }
+        return;
+    }
+
+    if (m_current == NODE && strcmp(name, "node") == 0) {
+        if (!m_rDocument.keep_node(m_nodes.back())) m_nodes.pop_back();
+        m_current = NONE;
+        count_element();
+        return;
+    }
+
+    if (m_current == WAY && strcmp(name, "way") == 0) {
+        m_current = NONE;
+        count_element();
+    }
+}
+
+
+/*
+ * k-way merge of the chunks in id order,
+ * the chunks of a sorted file are moved one after the other
+ */
+template <typename T, typename F>
+static
+void
+merge_by_id(std::vector<std::vector<T>*> sources, F add) {
+    std::vector<size_t> next(sources.size(), 0);
+    while (true) {
+        auto best = sources.size();
+        auto limit = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < sources.size(); ++i) {
+            if (next[i] == sources[i]->size()) continue;
+            auto id = (*sources[i])[next[i]].osm_id();
+            if (best == sources.size() || id < (*sources[best])[next[best]].osm_id()) {
+                if (best != sources.size()) limit = (*sources[best])[next[best]].osm_id();
+                best = i;
+            } else if (id < limit) {
+                limit = id;
+            }
+        }
+        if (best == sources.size()) break;
+
+        auto &source = *sources[best];
+        auto &position = next[best];
+        do {
+            add(std::move(source[position++]));
+        } while (position < source.size() && source[position].osm_id() < limit);
+    }
+
+    for (auto source : sources) {
+        std::vector<T>().swap(*source);
+    }
+}
+
+
+void
+OSMChunkParserCallback::merge(
+        std::vector<std::unique_ptr<OSMChunkParserCallback>> &chunks,
+        OSMDocument &doc) {
+    std::vector<OSMDocument::Nodes*> nodes;
+    std::vector<OSMDocument::Ways*> ways;
+    for (auto &chunk : chunks) {
+        nodes.push_back(&chunk->m_nodes);
+        ways.push_back(&chunk->m_ways);
+    }
+
+    merge_by_id(nodes, [&doc](Node &&node) {
+            doc.AddNode(std::move(node));
+            });
+
+    merge_by_id(ways, [&doc](Way &&way) {
+            for (const auto node_id : way.node_ids()) {
+                doc.link_node(way, node_id);
+            }
+            doc.AddWay(std::move(way));
+            });
+
+    OSMDocumentParserCallback relations(doc);
+    relations.relations_section();
+    xml::XMLParserCallback &callback = relations;
+    for (auto &chunk : chunks) {
+        for (const auto &element : chunk->m_relations) {
+            if (element.start) {
+                std::vector<const char*> atts;
+                for (const auto &att : element.atts) atts.push_back(att.c_str());
+                atts.push_back(NULL);
+                callback.StartElement(element.name.c_str(), atts.data());
+            } else {
+                callback.EndElement(element.name.c_str());
+            }
+        }
+        std::vector<Recorded>().swap(chunk->m_relations);
+    }
+    callback.EndElement("osm");
+}
+
+}  // end namespace osm2pgr
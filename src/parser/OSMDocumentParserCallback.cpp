@@ -32,7 +32,6 @@
 #include "osm_elements/osm_tag.h"
 #include "osm_elements/Way.h"
 #include "osm_elements/Node.h"
-#include "utilities/print_progress.h"
 
 
 namespace osm2pgr {
@@ -54,20 +53,14 @@ namespace osm2pgr {
   </relation>
  */
 
+/*
+ * The counter is published in batches, a relaxed store every 4096 elements
+ */
 void
-OSMDocumentParserCallback::show_progress() {
-#if 0
-    try {
-        if (m_line == 0) return;
-        assert(m_rDocument.lines());
-        if (m_rDocument.lines() == 0) return;
-        if (((++m_line) % (m_rDocument.lines() / 100)) == 0) {
-            print_progress(m_rDocument.lines(), m_line);
-        }
-    } catch(...) {
-        m_line = 1;
+OSMDocumentParserCallback::count_element() {
+    if (m_progress && ((++m_elements & 0xfff) == 0)) {
+        m_progress->elements.store(m_elements, std::memory_order_relaxed);
     }
-#endif
 }
 
 
@@ -78,8 +71,6 @@ void
 OSMDocumentParserCallback::StartElement(
         const char *name,
         const char** atts) {
-    show_progress();
-
     if (strcmp(name, "osm") == 0) {
         m_section = 1;
     }
@@ -92,7 +83,7 @@ OSMDocumentParserCallback::StartElement(
 
     if (m_section == 1) {
         if (strcmp(name, "node") == 0) {
-            last_node = new Node(atts);
+            last_node = new Node(atts, m_rDocument.node_attributes());
         }
         if (strcmp(name, "tag") == 0) {
             auto tag = last_node->add_tag(Tag(atts));
@@ -156,13 +147,14 @@ OSMDocumentParserCallback::StartElement(
 void OSMDocumentParserCallback::EndElement(const char* name) {
     if (strcmp(name, "osm") == 0) {
         m_rDocument.endOfFile();
-        show_progress();
+        if (m_progress) m_progress->elements.store(m_elements, std::memory_order_relaxed);
         return;
     }
 
     if (strcmp(name, "node") == 0) {
         m_rDocument.AddNode(*last_node);
         delete last_node;
+        count_element();
         return;
     }
     if (strcmp(name, "way") == 0) {
@@ -178,6 +170,7 @@ void OSMDocumentParserCallback::EndElement(const char* name) {
             }
         }
         delete last_way;
+        count_element();
         return;
     }
 
@@ -203,6 +196,7 @@ void OSMDocumentParserCallback::EndElement(const char* name) {
         }
         // TODO add all other relations
         delete last_relation;
+        count_element();
         return;
     } 
 }
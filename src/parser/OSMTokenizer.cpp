@@ -0,0 +1,543 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "parser/OSMTokenizer.h"
+
+#include <string.h>
+#include <strings.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace xml {
+
+namespace {
+
+/*
+ * The progress counter is updated once per step
+ */
+const size_t report_step = 1024 * 1024;
+
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+
+/*
+ * ASCII names only, anything else goes to expat
+ */
+inline bool is_name_start(char c) {
+    auto lower = static_cast<char>(c | 0x20);
+    return (lower >= 'a' && lower <= 'z') || c == '_' || c == ':';
+}
+
+
+inline bool is_name_char(char c) {
+    return is_name_start(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+
+const char*
+find(const char *from, const char *to, const char *pattern) {
+    auto found = std::search(from, to, pattern, pattern + strlen(pattern));
+    return found == to ? nullptr : found;
+}
+
+
+/*
+ * First byte of an attribute value that needs attention:
+ * the closing quote, '&', '<', a control byte or a non ASCII byte
+ */
+const char*
+find_special(const char *p, const char *end, char quote) {
+#ifdef __SSE2__
+    const __m128i quotes = _mm_set1_epi8(quote);
+    const __m128i amps = _mm_set1_epi8('&');
+    const __m128i lts = _mm_set1_epi8('<');
+    const __m128i spaces = _mm_set1_epi8(0x20);
+    while (end - p >= 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        /* signed compare: the non ASCII bytes are negative, below 0x20 */
+        auto hits = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, quotes), _mm_cmpeq_epi8(block, amps)),
+                _mm_or_si128(_mm_cmpeq_epi8(block, lts), _mm_cmplt_epi8(block, spaces)));
+        auto mask = _mm_movemask_epi8(hits);
+        if (mask) return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+#endif
+    while (p != end) {
+        auto c = static_cast<unsigned char>(*p);
+        if (c == static_cast<unsigned char>(quote) || c == '&' || c == '<' || c < 0x20 || c >= 0x80) return p;
+        ++p;
+    }
+    return end;
+}
+
+
+/*
+ * Length of the UTF-8 sequence, 0 when invalid or not an XML character
+ */
+size_t
+utf8_length(const char *p, const char *end) {
+    auto s = reinterpret_cast<const unsigned char*>(p);
+    auto available = static_cast<size_t>(end - p);
+    size_t len;
+    if (s[0] < 0xC2) return 0;
+    if (s[0] < 0xE0) {
+        len = 2;
+    } else if (s[0] < 0xF0) {
+        len = 3;
+    } else if (s[0] < 0xF5) {
+        len = 4;
+    } else {
+        return 0;
+    }
+    if (available < len) return 0;
+    for (size_t i = 1; i < len; ++i) {
+        if ((s[i] & 0xC0) != 0x80) return 0;
+    }
+    if (s[0] == 0xE0 && s[1] < 0xA0) return 0;  // overlong
+    if (s[0] == 0xED && s[1] >= 0xA0) return 0;  // surrogates
+    if (s[0] == 0xEF && s[1] == 0xBF && s[2] >= 0xBE) return 0;  // U+FFFE U+FFFF
+    if (s[0] == 0xF0 && s[1] < 0x90) return 0;  // overlong
+    if (s[0] == 0xF4 && s[1] >= 0x90) return 0;  // above U+10FFFF
+    return len;
+}
+
+
+void
+append_utf8(std::string &text, uint32_t code) {
+    if (code < 0x80) {
+        text += static_cast<char>(code);
+    } else if (code < 0x800) {
+        text += static_cast<char>(0xC0 | (code >> 6));
+        text += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        text += static_cast<char>(0xE0 | (code >> 12));
+        text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        text += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        text += static_cast<char>(0xF0 | (code >> 18));
+        text += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        text += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+
+bool
+is_xml_char(uint32_t code) {
+    return code == 0x9 || code == 0xA || code == 0xD
+        || (code >= 0x20 && code <= 0xD7FF)
+        || (code >= 0xE000 && code <= 0xFFFD)
+        || (code >= 0x10000 && code <= 0x10FFFF);
+}
+
+}  // namespace
+
+
+
+OSMTokenizer::OSMTokenizer(
+        XMLParserCallback &callback,
+        std::atomic<uint64_t> *bytes_read) :
+    m_callback(callback),
+    m_bytes_read(bytes_read),
+    m_absolute(true),
+    m_reported(0),
+    m_data(nullptr),
+    m_p(nullptr),
+    m_end(nullptr),
+    m_offset(0) {
+}
+
+
+OSMTokenizer::Status
+OSMTokenizer::ParseDocument(const char *data, size_t size) {
+    m_data = m_p = data;
+    m_end = data + size;
+    m_absolute = true;
+    m_reported = 0;
+
+    if (!prolog()) return reject(m_data);
+
+    m_text.clear();
+    m_atts.clear();
+    m_events.clear();
+    bool empty;
+    if (!start_tag(empty)) return reject(m_data);
+    m_root = m_text.c_str();
+    if (empty) m_events.push_back(Event{0, 0, 0, false});
+    replay();
+
+    return empty ? epilogue() : content(true);
+}
+
+
+OSMTokenizer::Status
+OSMTokenizer::ParseContent(const char *data, size_t size) {
+    m_data = m_p = data;
+    m_end = data + size;
+    m_absolute = false;
+    m_reported = 0;
+    return content(false);
+}
+
+
+OSMTokenizer::Status
+OSMTokenizer::reject(const char *where) {
+    m_offset = static_cast<size_t>(where - m_data);
+    report(where, true);
+    return REJECTED;
+}
+
+
+void
+OSMTokenizer::report(const char *position, bool last) {
+    if (!m_bytes_read) return;
+    auto offset = static_cast<size_t>(position - m_data);
+    if (!last && offset - m_reported < report_step) return;
+    if (m_absolute) {
+        m_bytes_read->store(offset, std::memory_order_relaxed);
+    } else {
+        m_bytes_read->fetch_add(offset - m_reported, std::memory_order_relaxed);
+    }
+    m_reported = offset;
+}
+
+
+void
+OSMTokenizer::skip_space() {
+    while (m_p != m_end && is_space(*m_p)) ++m_p;
+}
+
+
+/*
+ * optional byte order mark and declaration, up to the root element
+ */
+bool
+OSMTokenizer::prolog() {
+    if (m_end - m_p >= 3 && memcmp(m_p, "\xEF\xBB\xBF", 3) == 0) m_p += 3;
+
+    if (m_end - m_p >= 6 && memcmp(m_p, "<?xml", 5) == 0 && is_space(m_p[5])) {
+        auto close = find(m_p, m_end, "?>");
+        if (!close) return false;
+        std::string declaration(m_p, close);
+        auto encoding = declaration.find("encoding");
+        if (encoding != std::string::npos) {
+            auto quote = declaration.find_first_of("\"'", encoding);
+            if (quote == std::string::npos
+                    || declaration.size() < quote + 7
+                    || strncasecmp(declaration.c_str() + quote + 1, "utf-8", 5) != 0
+                    || declaration[quote + 6] != declaration[quote]) {
+                return false;
+            }
+        }
+        m_p = close + 2;
+    }
+
+    skip_space();
+    return m_end - m_p >= 2 && *m_p == '<' && is_name_start(m_p[1]);
+}
+
+
+/*
+ * elements below the root, delivered one at a time
+ */
+OSMTokenizer::Status
+OSMTokenizer::content(bool document) {
+    while (true) {
+        skip_space();
+        if (m_p == m_end) {
+            /* in a document the root is not closed: expat reports it */
+            if (document) return reject(m_p);
+            m_offset = static_cast<size_t>(m_p - m_data);
+            report(m_p, true);
+            return DONE;
+        }
+        if (*m_p != '<' || m_end - m_p < 2) return reject(m_p);
+
+        if (m_p[1] == '/') {
+            if (!document) return reject(m_p);
+            auto at = m_p;
+            m_text.assign(m_root);
+            m_text += '\0';
+            if (!end_tag(0)) return reject(at);
+            m_events.clear();
+            m_events.push_back(Event{0, 0, 0, false});
+            replay();
+            return epilogue();
+        }
+
+        auto start = m_p;
+        if (!element()) return reject(start);
+        replay();
+        report(m_p, false);
+    }
+}
+
+
+/*
+ * after the root: white space, comments and processing instructions
+ */
+OSMTokenizer::Status
+OSMTokenizer::epilogue() {
+    while (true) {
+        skip_space();
+        if (m_p == m_end) break;
+        const char *close = nullptr;
+        if (m_end - m_p >= 4 && memcmp(m_p, "<!--", 4) == 0) {
+            close = find(m_p + 4, m_end, "-->");
+            if (close) close += 3;
+        } else if (m_end - m_p >= 2 && memcmp(m_p, "<?", 2) == 0) {
+            close = find(m_p + 2, m_end, "?>");
+            if (close) close += 2;
+        }
+        if (!close) {
+            m_offset = static_cast<size_t>(m_p - m_data);
+            m_error = "junk after document element";
+            return FAILED;
+        }
+        m_p = close;
+    }
+    m_offset = static_cast<size_t>(m_p - m_data);
+    report(m_p, true);
+    return DONE;
+}
+
+
+/*
+ * An element with all its children, the events are kept until its end
+ */
+bool
+OSMTokenizer::element() {
+    m_text.clear();
+    m_atts.clear();
+    m_events.clear();
+    m_open.clear();
+
+    while (true) {
+        if (m_end - m_p < 2) return false;
+        if (m_p[1] == '/') {
+            if (m_open.empty() || !end_tag(m_open.back())) return false;
+            m_events.push_back(Event{m_open.back(), 0, 0, false});
+            m_open.pop_back();
+            if (m_open.empty()) return true;
+        } else {
+            auto name = m_text.size();
+            bool empty;
+            if (!start_tag(empty)) return false;
+            if (empty) {
+                m_events.push_back(Event{name, 0, 0, false});
+                if (m_open.empty()) return true;
+            } else {
+                m_open.push_back(name);
+            }
+        }
+
+        skip_space();
+        if (m_p == m_end || *m_p != '<') return false;
+    }
+}
+
+
+bool
+OSMTokenizer::start_tag(bool &empty) {
+    ++m_p;
+    auto element_name = m_text.size();
+    if (!name()) return false;
+
+    auto first_att = m_atts.size();
+    while (true) {
+        auto before = m_p;
+        skip_space();
+        if (m_p == m_end) return false;
+        if (*m_p == '>') {
+            ++m_p;
+            empty = false;
+            break;
+        }
+        if (*m_p == '/') {
+            if (m_end - m_p < 2 || m_p[1] != '>') return false;
+            m_p += 2;
+            empty = true;
+            break;
+        }
+        /* attributes are separated by white space */
+        if (m_p == before) return false;
+
+        auto att_name = m_text.size();
+        if (!name()) return false;
+        for (auto i = first_att; i < m_atts.size(); i += 2) {
+            if (strcmp(&m_text[m_atts[i]], &m_text[att_name]) == 0) return false;
+        }
+        skip_space();
+        if (m_p == m_end || *m_p != '=') return false;
+        ++m_p;
+        skip_space();
+        auto value = m_text.size();
+        if (!attribute_value()) return false;
+        m_atts.push_back(att_name);
+        m_atts.push_back(value);
+    }
+
+    m_events.push_back(Event{element_name, first_att, (m_atts.size() - first_att) / 2, true});
+    return true;
+}
+
+
+bool
+OSMTokenizer::end_tag(size_t element_name) {
+    m_p += 2;
+    auto expected = &m_text[element_name];
+    auto len = strlen(expected);
+    if (static_cast<size_t>(m_end - m_p) <= len || memcmp(m_p, expected, len) != 0) return false;
+    m_p += len;
+    skip_space();
+    if (m_p == m_end || *m_p != '>') return false;
+    ++m_p;
+    return true;
+}
+
+
+bool
+OSMTokenizer::name() {
+    auto begin = m_p;
+    if (m_p == m_end || !is_name_start(*m_p)) return false;
+    ++m_p;
+    while (m_p != m_end && is_name_char(*m_p)) ++m_p;
+    m_text.append(begin, static_cast<size_t>(m_p - begin));
+    m_text += '\0';
+    return true;
+}
+
+
+/*
+ * Normalized as expat does: tab, new line and carriage return
+ * (or carriage return + new line) become a space
+ */
+bool
+OSMTokenizer::attribute_value() {
+    if (m_p == m_end || (*m_p != '"' && *m_p != '\'')) return false;
+    auto quote = *m_p++;
+
+    while (true) {
+        auto special = find_special(m_p, m_end, quote);
+        m_text.append(m_p, static_cast<size_t>(special - m_p));
+        m_p = special;
+        if (m_p == m_end) return false;
+
+        auto c = static_cast<unsigned char>(*m_p);
+        if (c == static_cast<unsigned char>(quote)) {
+            ++m_p;
+            break;
+        }
+        if (c == '&') {
+            if (!entity()) return false;
+            continue;
+        }
+        if (c == '\t' || c == '\n' || c == '\r') {
+            m_text += ' ';
+            ++m_p;
+            if (c == '\r' && m_p != m_end && *m_p == '\n') ++m_p;
+            continue;
+        }
+        if (c < 0x80) return false;  // '<' or a control character
+
+        auto len = utf8_length(m_p, m_end);
+        if (!len) return false;
+        m_text.append(m_p, len);
+        m_p += len;
+    }
+    m_text += '\0';
+    return true;
+}
+
+
+bool
+OSMTokenizer::entity() {
+    auto semicolon = static_cast<const char*>(
+            memchr(m_p, ';', std::min<size_t>(static_cast<size_t>(m_end - m_p), 12)));
+    if (!semicolon) return false;
+    auto begin = m_p + 1;
+    auto len = static_cast<size_t>(semicolon - begin);
+
+    if (len == 2 && memcmp(begin, "lt", 2) == 0) {
+        m_text += '<';
+    } else if (len == 2 && memcmp(begin, "gt", 2) == 0) {
+        m_text += '>';
+    } else if (len == 3 && memcmp(begin, "amp", 3) == 0) {
+        m_text += '&';
+    } else if (len == 4 && memcmp(begin, "quot", 4) == 0) {
+        m_text += '"';
+    } else if (len == 4 && memcmp(begin, "apos", 4) == 0) {
+        m_text += '\'';
+    } else if (len >= 2 && begin[0] == '#') {
+        bool hex = begin[1] == 'x';
+        auto digit = begin + (hex ? 2 : 1);
+        if (digit == semicolon) return false;
+        uint32_t code = 0;
+        for (; digit != semicolon; ++digit) {
+            auto c = *digit;
+            uint32_t value;
+            if (c >= '0' && c <= '9') {
+                value = static_cast<uint32_t>(c - '0');
+            } else if (hex && (c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+                value = static_cast<uint32_t>((c | 0x20) - 'a' + 10);
+            } else {
+                return false;
+            }
+            code = code * (hex ? 16 : 10) + value;
+            if (code > 0x10FFFF) return false;
+        }
+        if (!is_xml_char(code)) return false;
+        append_utf8(m_text, code);
+    } else {
+        return false;
+    }
+    m_p = semicolon + 1;
+    return true;
+}
+
+
+void
+OSMTokenizer::replay() {
+    for (const auto &event : m_events) {
+        if (event.start) {
+            m_pointers.clear();
+            for (size_t i = 0; i < 2 * event.atts; ++i) {
+                m_pointers.push_back(&m_text[m_atts[event.first_att + i]]);
+            }
+            m_pointers.push_back(nullptr);
+            m_callback.StartElement(&m_text[event.name], m_pointers.data());
+        } else {
+            m_callback.EndElement(&m_text[event.name]);
+        }
+    }
+}
+
+}  // end namespace xml
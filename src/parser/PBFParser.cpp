@@ -0,0 +1,686 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "parser/PBFParser.h"
+
+#include <zlib.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utilities/thread_pool.h"
+
+
+namespace xml {
+
+namespace {
+
+/*
+ * Element and attribute names as they appear on an .osm file
+ */
+enum Name {OSM, NODE, WAY, RELATION, TAG, ND, MEMBER};
+const char* const names[] = {"osm", "node", "way", "relation", "tag", "nd", "member"};
+
+enum Key {ID, LAT, LON, VERSION, TIMESTAMP, CHANGESET, UID, USER, VISIBLE, K, V, REF, TYPE, ROLE};
+const char* const keys[] = {
+    "id", "lat", "lon", "version", "timestamp", "changeset", "uid", "user", "visible",
+    "k", "v", "ref", "type", "role"};
+
+const char* const member_types[] = {"node", "way", "relation"};
+
+/*
+ * limits from the format specification
+ */
+const uint32_t max_blob_header_size = 64 * 1024;
+const uint32_t max_uncompressed_blob_size = 32 * 1024 * 1024;
+
+
+/*
+ * Minimal protocol buffers reader: only what the OSM PBF messages use
+ */
+class ProtoReader {
+ public:
+     ProtoReader(const char *data, size_t size) :
+         m_data(reinterpret_cast<const uint8_t*>(data)),
+         m_end(reinterpret_cast<const uint8_t*>(data) + size),
+         m_tag(0),
+         m_type(0) {}
+
+     explicit ProtoReader(const std::pair<const char*, size_t> &bytes) :
+         ProtoReader(bytes.first, bytes.second) {}
+
+     //! advances to the next field, false at the end of the message
+     bool next() {
+         if (m_data == m_end) return false;
+         auto key = varint();
+         m_tag = static_cast<uint32_t>(key >> 3);
+         m_type = static_cast<uint32_t>(key & 0x07);
+         return true;
+     }
+
+     inline uint32_t tag() const {return m_tag;}
+
+     uint64_t varint() {
+         uint64_t value = 0;
+         for (int shift = 0; shift < 64; shift += 7) {
+             if (m_data == m_end) throw std::runtime_error("PBF: truncated varint");
+             auto byte = *m_data++;
+             value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+             if (!(byte & 0x80)) return value;
+         }
+         throw std::runtime_error("PBF: varint too long");
+     }
+
+     int64_t svarint() {
+         auto value = varint();
+         return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+     }
+
+     std::pair<const char*, size_t> bytes() {
+         auto size = varint();
+         if (size > static_cast<uint64_t>(m_end - m_data)) {
+             throw std::runtime_error("PBF: truncated message");
+         }
+         std::pair<const char*, size_t> result(reinterpret_cast<const char*>(m_data), static_cast<size_t>(size));
+         m_data += size;
+         return result;
+     }
+
+     std::string string() {
+         auto value = bytes();
+         return std::string(value.first, value.second);
+     }
+
+     void skip() {
+         switch (m_type) {
+             case 0: varint(); break;
+             case 1: advance(8); break;
+             case 2: bytes(); break;
+             case 5: advance(4); break;
+             default: throw std::runtime_error("PBF: unknown wire type");
+         }
+     }
+
+     //! values of a packed varint field
+     std::vector<uint64_t> packed() {
+         std::vector<uint64_t> values;
+         if (m_type != 2) {
+             values.push_back(varint());
+             return values;
+         }
+         ProtoReader reader(bytes());
+         while (reader.m_data != reader.m_end) values.push_back(reader.varint());
+         return values;
+     }
+
+     //! values of a packed zig-zag encoded field, optionally delta decoded
+     std::vector<int64_t> packed_signed(bool delta) {
+         std::vector<int64_t> values;
+         int64_t last = 0;
+         for (const auto value : packed()) {
+             auto decoded = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+             last = delta ? last + decoded : decoded;
+             values.push_back(last);
+         }
+         return values;
+     }
+
+ private:
+     void advance(size_t n) {
+         if (n > static_cast<size_t>(m_end - m_data)) {
+             throw std::runtime_error("PBF: truncated message");
+         }
+         m_data += n;
+     }
+
+ private:
+     const uint8_t *m_data;
+     const uint8_t *m_end;
+     uint32_t m_tag;
+     uint32_t m_type;
+};
+
+
+/*
+ * The content of a PrimitiveBlock converted to parser events.
+ *
+ * Strings are stored nul terminated in the arena and referenced by offset,
+ * so the block can grow while being decoded on a worker thread.
+ */
+class DecodedBlock {
+ public:
+     struct Attribute {
+         uint8_t key;
+         uint32_t value;
+     };
+     struct Event {
+         uint8_t name;
+         bool start;
+         uint32_t first;
+         uint32_t size;
+     };
+
+     void start(Name name) {
+         Event event = {static_cast<uint8_t>(name), true, static_cast<uint32_t>(m_atts.size()), 0};
+         m_events.push_back(event);
+     }
+
+     void end(Name name) {
+         Event event = {static_cast<uint8_t>(name), false, 0, 0};
+         m_events.push_back(event);
+     }
+
+     void attribute(Key key, const char *value, size_t size) {
+         Attribute att = {static_cast<uint8_t>(key), static_cast<uint32_t>(m_arena.size())};
+         m_arena.append(value, size);
+         m_arena.push_back('\0');
+         m_atts.push_back(att);
+         ++m_events.back().size;
+     }
+
+     void attribute(Key key, const std::pair<const char*, size_t> &value) {
+         attribute(key, value.first, value.second);
+     }
+
+     void attribute(Key key, int64_t value) {
+         char buf[24];
+         auto len = snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+         attribute(key, buf, static_cast<size_t>(len));
+     }
+
+     /* nanodegrees, written with 7 decimals like the .osm writers */
+     void coordinate(Key key, int64_t nano) {
+         int64_t value = (nano >= 0 ? nano + 50 : nano - 50) / 100;
+         char buf[32];
+         auto abs_value = value < 0 ? -value : value;
+         auto len = snprintf(buf, sizeof(buf), "%s%lld.%07lld",
+                 value < 0 ? "-" : "",
+                 static_cast<long long>(abs_value / 10000000),
+                 static_cast<long long>(abs_value % 10000000));
+         while (buf[len - 1] == '0') --len;
+         if (buf[len - 1] == '.') --len;
+         attribute(key, buf, static_cast<size_t>(len));
+     }
+
+     void timestamp(int64_t seconds) {
+         time_t t = static_cast<time_t>(seconds);
+         struct tm tm;
+         gmtime_r(&t, &tm);
+         char buf[32];
+         auto len = strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+         attribute(TIMESTAMP, buf, len);
+     }
+
+     /* sends the events to the callback */
+     void replay(XMLParserCallback &callback) const {
+         std::vector<const char*> atts;
+         for (const auto &event : m_events) {
+             if (!event.start) {
+                 callback.EndElement(names[event.name]);
+                 continue;
+             }
+             atts.clear();
+             for (auto i = event.first; i < event.first + event.size; ++i) {
+                 atts.push_back(keys[m_atts[i].key]);
+                 atts.push_back(m_arena.data() + m_atts[i].value);
+             }
+             atts.push_back(nullptr);
+             callback.StartElement(names[event.name], atts.data());
+         }
+     }
+
+     inline size_t elements() const {return m_events.size() / 2;}
+
+ private:
+     std::string m_arena;
+     std::vector<Attribute> m_atts;
+     std::vector<Event> m_events;
+};
+
+
+/*
+ * Blob message: returns the uncompressed content
+ */
+std::string
+inflate_blob(const std::string &blob) {
+    ProtoReader reader(blob.data(), blob.size());
+    std::pair<const char*, size_t> zlib_data(nullptr, 0);
+    uint64_t raw_size = 0;
+
+    while (reader.next()) {
+        switch (reader.tag()) {
+            case 1:  // raw
+                return reader.string();
+            case 2:
+                raw_size = reader.varint();
+                break;
+            case 3:
+                zlib_data = reader.bytes();
+                break;
+            case 4:
+            case 5:
+            case 6:
+            case 7:
+                throw std::runtime_error("PBF: only raw and zlib compressed blobs are supported");
+            default:
+                reader.skip();
+        }
+    }
+    if (!zlib_data.first) throw std::runtime_error("PBF: empty blob");
+    if (raw_size > max_uncompressed_blob_size) throw std::runtime_error("PBF: blob too large");
+
+    std::string data(static_cast<size_t>(raw_size), '\0');
+    uLongf size = static_cast<uLongf>(raw_size);
+    if (uncompress(
+                reinterpret_cast<Bytef*>(&data[0]), &size,
+                reinterpret_cast<const Bytef*>(zlib_data.first),
+                static_cast<uLong>(zlib_data.second)) != Z_OK
+            || size != raw_size) {
+        throw std::runtime_error("PBF: failed to inflate blob");
+    }
+    return data;
+}
+
+
+/*
+ * HeaderBlock: only the required features are of interest
+ */
+void
+check_header(const std::string &blob) {
+    auto data = inflate_blob(blob);
+    ProtoReader reader(data.data(), data.size());
+    while (reader.next()) {
+        if (reader.tag() == 4) {
+            auto feature = reader.string();
+            if (feature != "OsmSchema-V0.6" && feature != "DenseNodes") {
+                throw std::runtime_error("PBF: unsupported required feature " + feature);
+            }
+        } else {
+            reader.skip();
+        }
+    }
+}
+
+
+class PrimitiveBlock {
+ public:
+     explicit PrimitiveBlock(const std::string &data) :
+         m_data(data),
+         m_granularity(100),
+         m_date_granularity(1000),
+         m_lat_offset(0),
+         m_lon_offset(0) {
+         ProtoReader reader(m_data.data(), m_data.size());
+         while (reader.next()) {
+             switch (reader.tag()) {
+                 case 1: {
+                             ProtoReader table(reader.bytes());
+                             while (table.next()) {
+                                 if (table.tag() == 1) {
+                                     m_strings.push_back(table.bytes());
+                                 } else {
+                                     table.skip();
+                                 }
+                             }
+                             break;
+                         }
+                 case 2: m_groups.push_back(reader.bytes()); break;
+                 case 17: m_granularity = static_cast<int64_t>(reader.varint()); break;
+                 case 18: m_date_granularity = static_cast<int64_t>(reader.varint()); break;
+                 case 19: m_lat_offset = static_cast<int64_t>(reader.varint()); break;
+                 case 20: m_lon_offset = static_cast<int64_t>(reader.varint()); break;
+                 default: reader.skip();
+             }
+         }
+     }
+
+     DecodedBlock decode() const {
+         DecodedBlock block;
+         for (const auto &group : m_groups) {
+             ProtoReader reader(group);
+             while (reader.next()) {
+                 switch (reader.tag()) {
+                     case 1: node(reader.bytes(), block); break;
+                     case 2: dense(reader.bytes(), block); break;
+                     case 3: way(reader.bytes(), block); break;
+                     case 4: relation(reader.bytes(), block); break;
+                     default: reader.skip();
+                 }
+             }
+         }
+         return block;
+     }
+
+ private:
+     const std::pair<const char*, size_t>& str(uint64_t index) const {
+         if (index >= m_strings.size()) throw std::runtime_error("PBF: string index out of range");
+         return m_strings[static_cast<size_t>(index)];
+     }
+
+     int64_t lat(int64_t value) const {return m_lat_offset + m_granularity * value;}
+     int64_t lon(int64_t value) const {return m_lon_offset + m_granularity * value;}
+     int64_t seconds(int64_t value) const {return value * m_date_granularity / 1000;}
+
+     void tags(
+             const std::vector<uint64_t> &k,
+             const std::vector<uint64_t> &v,
+             DecodedBlock &block) const {
+         if (k.size() != v.size()) throw std::runtime_error("PBF: keys and values do not match");
+         for (size_t i = 0; i < k.size(); ++i) {
+             block.start(TAG);
+             block.attribute(K, str(k[i]));
+             block.attribute(V, str(v[i]));
+             block.end(TAG);
+         }
+     }
+
+     /* Info message as attributes of the current element */
+     void info(const std::pair<const char*, size_t> &bytes, DecodedBlock &block) const {
+         ProtoReader reader(bytes);
+         while (reader.next()) {
+             switch (reader.tag()) {
+                 case 1: block.attribute(VERSION, static_cast<int64_t>(reader.varint())); break;
+                 case 2: block.timestamp(seconds(static_cast<int64_t>(reader.varint()))); break;
+                 case 3: block.attribute(CHANGESET, static_cast<int64_t>(reader.varint())); break;
+                 case 4: block.attribute(UID, static_cast<int32_t>(reader.varint())); break;
+                 case 5: block.attribute(USER, str(reader.varint())); break;
+                 case 6: {
+                             auto visible = reader.varint() != 0;
+                             block.attribute(VISIBLE, visible ? "true" : "false", visible ? 4 : 5);
+                             break;
+                         }
+                 default: reader.skip();
+             }
+         }
+     }
+
+     void node(const std::pair<const char*, size_t> &bytes, DecodedBlock &block) const {
+         ProtoReader reader(bytes);
+         int64_t id = 0, latitude = 0, longitude = 0;
+         std::vector<uint64_t> k, v;
+         std::pair<const char*, size_t> node_info(nullptr, 0);
+         while (reader.next()) {
+             switch (reader.tag()) {
+                 case 1: id = reader.svarint(); break;
+                 case 2: k = reader.packed(); break;
+                 case 3: v = reader.packed(); break;
+                 case 4: node_info = reader.bytes(); break;
+                 case 8: latitude = reader.svarint(); break;
+                 case 9: longitude = reader.svarint(); break;
+                 default: reader.skip();
+             }
+         }
+         block.start(NODE);
+         block.attribute(ID, id);
+         block.coordinate(LAT, lat(latitude));
+         block.coordinate(LON, lon(longitude));
+         if (node_info.first) info(node_info, block);
+         tags(k, v, block);
+         block.end(NODE);
+     }
+
+     void dense(const std::pair<const char*, size_t> &bytes, DecodedBlock &block) const {
+         ProtoReader reader(bytes);
+         std::vector<int64_t> ids, lats, lons;
+         std::vector<uint64_t> keys_vals;
+         std::vector<uint64_t> versions;
+         std::vector<int64_t> timestamps, changesets, uids, user_sids;
+         std::vector<uint64_t> visibles;
+         while (reader.next()) {
+             switch (reader.tag()) {
+                 case 1: ids = reader.packed_signed(true); break;
+                 case 5: {
+                             ProtoReader dense_info(reader.bytes());
+                             while (dense_info.next()) {
+                                 switch (dense_info.tag()) {
+                                     case 1: versions = dense_info.packed(); break;
+                                     case 2: timestamps = dense_info.packed_signed(true); break;
+                                     case 3: changesets = dense_info.packed_signed(true); break;
+                                     case 4: uids = dense_info.packed_signed(true); break;
+                                     case 5: user_sids = dense_info.packed_signed(true); break;
+                                     case 6: visibles = dense_info.packed(); break;
+                                     default: dense_info.skip();
+                                 }
+                             }
+                             break;
+                         }
+                 case 8: lats = reader.packed_signed(true); break;
+                 case 9: lons = reader.packed_signed(true); break;
+                 case 10: keys_vals = reader.packed(); break;
+                 default: reader.skip();
+             }
+         }
+         if (lats.size() != ids.size() || lons.size() != ids.size()) {
+             throw std::runtime_error("PBF: dense nodes arrays do not match");
+         }
+
+         size_t kv = 0;
+         for (size_t i = 0; i < ids.size(); ++i) {
+             block.start(NODE);
+             block.attribute(ID, ids[i]);
+             block.coordinate(LAT, lat(lats[i]));
+             block.coordinate(LON, lon(lons[i]));
+             if (i < versions.size()) block.attribute(VERSION, static_cast<int64_t>(versions[i]));
+             if (i < timestamps.size()) block.timestamp(seconds(timestamps[i]));
+             if (i < changesets.size()) block.attribute(CHANGESET, changesets[i]);
+             if (i < uids.size()) block.attribute(UID, uids[i]);
+             if (i < user_sids.size()) block.attribute(USER, str(static_cast<uint64_t>(user_sids[i])));
+             if (i < visibles.size()) block.attribute(VISIBLE, visibles[i] ? "true" : "false", visibles[i] ? 4 : 5);
+
+             /*
+              * keys_vals: (key, value)* 0 for each node, empty when no node has tags
+              */
+             while (kv < keys_vals.size() && keys_vals[kv] != 0) {
+                 if (kv + 1 >= keys_vals.size()) throw std::runtime_error("PBF: truncated keys_vals");
+                 block.start(TAG);
+                 block.attribute(K, str(keys_vals[kv]));
+                 block.attribute(V, str(keys_vals[kv + 1]));
+                 block.end(TAG);
+                 kv += 2;
+             }
+             ++kv;
+             block.end(NODE);
+         }
+     }
+
+     void way(const std::pair<const char*, size_t> &bytes, DecodedBlock &block) const {
+         ProtoReader reader(bytes);
+         int64_t id = 0;
+         std::vector<uint64_t> k, v;
+         std::vector<int64_t> refs;
+         std::pair<const char*, size_t> way_info(nullptr, 0);
+         while (reader.next()) {
+             switch (reader.tag()) {
+                 case 1: id = static_cast<int64_t>(reader.varint()); break;
+                 case 2: k = reader.packed(); break;
+                 case 3: v = reader.packed(); break;
+                 case 4: way_info = reader.bytes(); break;
+                 case 8: refs = reader.packed_signed(true); break;
+                 default: reader.skip();
+             }
+         }
+         block.start(WAY);
+         block.attribute(ID, id);
+         if (way_info.first) info(way_info, block);
+         for (const auto ref : refs) {
+             block.start(ND);
+             block.attribute(REF, ref);
+             block.end(ND);
+         }
+         tags(k, v, block);
+         block.end(WAY);
+     }
+
+     void relation(const std::pair<const char*, size_t> &bytes, DecodedBlock &block) const {
+         ProtoReader reader(bytes);
+         int64_t id = 0;
+         std::vector<uint64_t> k, v, roles, types;
+         std::vector<int64_t> memids;
+         std::pair<const char*, size_t> relation_info(nullptr, 0);
+         while (reader.next()) {
+             switch (reader.tag()) {
+                 case 1: id = static_cast<int64_t>(reader.varint()); break;
+                 case 2: k = reader.packed(); break;
+                 case 3: v = reader.packed(); break;
+                 case 4: relation_info = reader.bytes(); break;
+                 case 8: roles = reader.packed(); break;
+                 case 9: memids = reader.packed_signed(true); break;
+                 case 10: types = reader.packed(); break;
+                 default: reader.skip();
+             }
+         }
+         if (roles.size() != memids.size() || types.size() != memids.size()) {
+             throw std::runtime_error("PBF: relation members do not match");
+         }
+         block.start(RELATION);
+         block.attribute(ID, id);
+         if (relation_info.first) info(relation_info, block);
+         for (size_t i = 0; i < memids.size(); ++i) {
+             if (types[i] > 2) throw std::runtime_error("PBF: unknown member type");
+             block.start(MEMBER);
+             block.attribute(TYPE, member_types[types[i]], strlen(member_types[types[i]]));
+             block.attribute(REF, memids[i]);
+             block.attribute(ROLE, str(roles[i]));
+             block.end(MEMBER);
+         }
+         tags(k, v, block);
+         block.end(RELATION);
+     }
+
+ private:
+     std::string m_data;
+     std::vector<std::pair<const char*, size_t>> m_strings;
+     std::vector<std::pair<const char*, size_t>> m_groups;
+     int64_t m_granularity;
+     int64_t m_date_granularity;
+     int64_t m_lat_offset;
+     int64_t m_lon_offset;
+};
+
+
+DecodedBlock
+decode_data(const std::string &blob) {
+    return PrimitiveBlock(inflate_blob(blob)).decode();
+}
+
+
+bool
+read_exactly(FILE *fp, std::string &buffer, size_t size) {
+    buffer.resize(size);
+    return size == 0 || fread(&buffer[0], 1, size, fp) == size;
+}
+
+}  // namespace
+
+
+
+int PBFParser::Parse(
+        XMLParserCallback& rCallback,
+        const char* chFileName,
+        std::atomic<uint64_t> *bytes_read) {
+    FILE* fp = fopen(chFileName, "rb");
+    if (!fp) {
+        std::cerr <<  "Error opening " << chFileName << ":" << strerror(errno);
+        return 1;  // File not found
+    }
+
+    osm2pgr::ThreadPool pool(m_threads);
+    /*
+     * blobs being decoded, bounded to keep the memory usage flat,
+     * with the file offset of the end of the blob
+     */
+    std::deque<std::pair<uint64_t, std::future<DecodedBlock>>> pending;
+    uint64_t offset = 0;
+    auto replay_front = [&]() {
+        pending.front().second.get().replay(rCallback);
+        if (bytes_read) bytes_read->store(pending.front().first, std::memory_order_relaxed);
+        pending.pop_front();
+    };
+    const size_t max_pending = 2 * pool.size();
+
+    const char* osm_atts[] = {"version", "0.6", nullptr};
+    rCallback.StartElement(names[OSM], osm_atts);
+
+    try {
+        std::string header;
+        std::string blob;
+        while (true) {
+            unsigned char size_buf[4];
+            auto len = fread(size_buf, 1, sizeof(size_buf), fp);
+            if (len == 0 && feof(fp)) break;
+            if (len != sizeof(size_buf)) throw std::runtime_error("PBF: truncated blob header size");
+
+            uint32_t header_size =
+                (static_cast<uint32_t>(size_buf[0]) << 24)
+                | (static_cast<uint32_t>(size_buf[1]) << 16)
+                | (static_cast<uint32_t>(size_buf[2]) << 8)
+                | static_cast<uint32_t>(size_buf[3]);
+            if (header_size > max_blob_header_size) throw std::runtime_error("PBF: blob header too large");
+            if (!read_exactly(fp, header, header_size)) throw std::runtime_error("PBF: truncated blob header");
+
+            std::string type;
+            uint64_t data_size = 0;
+            ProtoReader reader(header.data(), header.size());
+            while (reader.next()) {
+                switch (reader.tag()) {
+                    case 1: type = reader.string(); break;
+                    case 3: data_size = reader.varint(); break;
+                    default: reader.skip();
+                }
+            }
+            if (data_size > max_uncompressed_blob_size) throw std::runtime_error("PBF: blob too large");
+            if (!read_exactly(fp, blob, static_cast<size_t>(data_size))) throw std::runtime_error("PBF: truncated blob");
+            offset += sizeof(size_buf) + header_size + data_size;
+
+            if (type == "OSMHeader") {
+                check_header(blob);
+            } else if (type == "OSMData") {
+                pending.emplace_back(offset, pool.submit([data = std::move(blob)]() {return decode_data(data);}));
+                while (pending.size() >= max_pending) replay_front();
+            }
+            /* unknown blob types are skipped as the format allows */
+        }
+
+        while (!pending.empty()) replay_front();
+        if (bytes_read) bytes_read->store(offset, std::memory_order_relaxed);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << " in " << chFileName;
+        fclose(fp);
+        return 2;  // parsing error
+    }
+
+    rCallback.EndElement(names[OSM]);
+    fclose(fp);
+    return 0;
+}
+
+}  // end namespace xml
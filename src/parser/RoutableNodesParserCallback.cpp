@@ -0,0 +1,133 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "parser/RoutableNodesParserCallback.h"
+
+#include <string.h>
+#include <boost/lexical_cast.hpp>
+#include <cstdint>
+#include <string>
+#include "osm_elements/osm_tag.h"
+
+
+namespace osm2pgr {
+
+/*
+ * value of the attribute, NULL when missing
+ */
+static
+const char*
+attribute(const char **atts, const char *key) {
+    for (auto attribut = atts; *attribut != NULL; attribut += 2) {
+        if (strcmp(attribut[0], key) == 0) return attribut[1];
+    }
+    return NULL;
+}
+
+
+static
+int64_t
+id_attribute(const char **atts, const char *key) {
+    auto value = attribute(atts, key);
+    return value ? boost::lexical_cast<int64_t>(value) : -1;
+}
+
+
+void
+RoutableNodesParserCallback::count_element() {
+    if (m_progress && ((++m_elements & 0xfff) == 0)) {
+        m_progress->elements.store(m_elements, std::memory_order_relaxed);
+    }
+}
+
+
+void
+RoutableNodesParserCallback::StartElement(
+        const char *name,
+        const char** atts) {
+    if (strcmp(name, "way") == 0) {
+        m_current = WAY;
+        m_id = id_attribute(atts, "id");
+        m_routable = m_promoted_pass && m_promoted.has(m_id);
+        m_refs.clear();
+        return;
+    }
+
+    if (strcmp(name, "relation") == 0) {
+        m_current = m_promoted_pass ? NONE : RELATION;
+        m_routable = false;
+        m_refs.clear();
+        return;
+    }
+
+    if (m_current == NONE) return;
+
+    if (strcmp(name, "tag") == 0) {
+        if (!m_promoted_pass && m_rConfig.has_tag(Tag(atts))) m_routable = true;
+        return;
+    }
+
+    if (m_current == WAY && strcmp(name, "nd") == 0) {
+        m_refs.push_back(id_attribute(atts, "ref"));
+        return;
+    }
+
+    if (m_current == RELATION && strcmp(name, "member") == 0) {
+        auto type = attribute(atts, "type");
+        if (type && strcmp(type, "way") == 0) m_refs.push_back(id_attribute(atts, "ref"));
+    }
+}
+
+
+void
+RoutableNodesParserCallback::EndElement(const char* name) {
+    if (strcmp(name, "osm") == 0) {
+        if (m_progress) m_progress->elements.store(m_elements, std::memory_order_relaxed);
+        return;
+    }
+
+    if (strcmp(name, "node") == 0) {
+        count_element();
+        return;
+    }
+
+    if (m_current == WAY && strcmp(name, "way") == 0) {
+        if (m_routable) {
+            if (!m_promoted_pass) m_ways.set(m_id);
+            for (const auto node_id : m_refs) m_nodes.set(node_id);
+        }
+        m_current = NONE;
+        count_element();
+        return;
+    }
+
+    if (strcmp(name, "relation") == 0) {
+        if (m_current == RELATION && m_routable) {
+            for (const auto way_id : m_refs) {
+                if (!m_ways.has(way_id)) m_promoted.set(way_id);
+            }
+        }
+        m_current = NONE;
+        count_element();
+    }
+}
+
+}  // end namespace osm2pgr
@@ -22,14 +22,41 @@
 #include "parser/XMLParser.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "parser/decompress.h"
+#include "parser/OSMTokenizer.h"
+#include "utilities/buffer_queue.h"
+#include "utilities/thread_pool.h"
 
 
 
 namespace xml {
 
+/*
+ * Size of the pieces handed to expat
+ */
+static const size_t window_size = 4 * 1024 * 1024;
+
+/*
+ * Buffers between the decompressing thread and expat
+ */
+static const size_t queue_size = 4;
+
 //------------------------------------- global Expat Callbacks:
 
 static void startElement(void *userData, const char *name, const char **atts) {
@@ -45,49 +72,530 @@ static void endElement(void *userData, const char *name) {
 }
 
 
+static int parse_error(XML_Parser parser) {
+    std::cerr <<
+        XML_ErrorString(XML_GetErrorCode(parser))
+        << " at line "
+        << static_cast<int>(XML_GetCurrentLineNumber(parser));
+    return 2;    // return = 2 indicating parsing error
+}
+
+
+/*
+ * copies the data into expat's own buffer and parses it
+ */
+static bool parse_window(XML_Parser parser, const char *data, size_t len, bool done) {
+  if (len == 0) return XML_Parse(parser, data, 0, done) != XML_STATUS_ERROR;
+
+  void *buf = XML_GetBuffer(parser, static_cast<int>(len));
+  if (!buf) return false;
+  memcpy(buf, data, len);
+  return XML_ParseBuffer(parser, static_cast<int>(len), done) != XML_STATUS_ERROR;
+}
+
+
+/*
+ * Hides the start of the element reopened to resume a document with expat
+ */
+class ResumedCallback : public XMLParserCallback {
+ public:
+  explicit ResumedCallback(XMLParserCallback &callback) :
+    m_callback(callback),
+    m_reopened(false) {}
+
+  void StartElement(const char *name, const char** atts) {
+    if (m_reopened) m_callback.StartElement(name, atts);
+    m_reopened = true;
+  }
+
+  void EndElement(const char *name) {m_callback.EndElement(name);}
 
+ private:
+  XMLParserCallback &m_callback;
+  bool m_reopened;
+};
 
-int XMLParser::Parse(XMLParserCallback& rCallback, const char* chFileName) {
-  int ret = 1;  // File not found
 
-  FILE* fp = fopen(chFileName, "rb");
-  if (fp) {
-    XML_Parser parser = XML_ParserCreate(NULL);
+/*
+ * The rest of a document, after the tokenizer stopped inside the root
+ */
+static int parse_resumed(
+    XMLParserCallback &rCallback,
+    const std::string &root,
+    const char *data, size_t offset, size_t size,
+    std::atomic<uint64_t> *bytes_read) {
+  ResumedCallback callback(rCallback);
+  XML_Parser parser = XML_ParserCreate(NULL);
+  XML_SetUserData(parser, static_cast<void*>(&callback));
+  XML_SetElementHandler(parser, startElement, endElement);
 
-    XML_SetUserData(parser, static_cast<void*>(&rCallback));
+  /* line numbers would count from the resume point */
+  auto open_tag = "<" + root + ">";
+  bool ok = parse_window(parser, open_tag.data(), open_tag.size(), offset == size);
+  auto start = offset;
+  for (; ok && offset < size; offset += window_size) {
+    auto len = std::min(window_size, size - offset);
+    ok = parse_window(parser, data + offset, len, offset + len == size);
+    if (ok && bytes_read) bytes_read->store(offset + len, std::memory_order_relaxed);
+  }
+  if (!ok) {
+    auto index = XML_GetCurrentByteIndex(parser) - static_cast<XML_Index>(open_tag.size());
+    std::cerr <<
+        XML_ErrorString(XML_GetErrorCode(parser))
+        << " at offset "
+        << start + static_cast<size_t>(std::max<XML_Index>(index, 0));
+  }
+  XML_ParserFree(parser);
+  return ok ? 0 : 2;
+}
 
-    // register Callbacks for start- and end-element events of the parser:
-    XML_SetElementHandler(parser, startElement, endElement);
 
-    int done;
-    do {  // loop over whole file content
-      char buf[BUFSIZ];
-      size_t len = fread(buf, 1, sizeof(buf), fp);    // read chunk of data
-      // end of file reached if buffer not completely filled
-      done = len < sizeof(buf);
-      if (!XML_Parse(parser, buf, static_cast<int>(len), done)) {
-        // a parse error occurred:
-          std::cerr <<
-            XML_ErrorString(XML_GetErrorCode(parser))
-            << " at line "
-            << static_cast<int>(XML_GetCurrentLineNumber(parser));
-        fclose(fp);
-        ret = 2;    // quit, return = 2 indicating parsing error
-        done = 1;
-        return ret;
+/*
+ * Consumer side: parses the buffers of the producer thread
+ */
+static int parse_queue(
+    XML_Parser parser,
+    osm2pgr::BufferQueue &queue,
+    std::atomic<uint64_t> *bytes_read) {
+  int ret = 0;
+  try {
+    osm2pgr::Buffer buffer;
+    bool more;
+    do {
+      more = queue.pop(buffer);
+      if (!parse_window(parser, buffer.data.get(), buffer.size, !more)) {
+        ret = parse_error(parser);
+        break;
       }
-    } while (!done);
+      if (bytes_read) bytes_read->store(buffer.input_offset, std::memory_order_relaxed);
+      queue.release(std::move(buffer));
+    } while (more);
+  } catch (const std::exception &e) {
+    std::cerr << e.what();
+    ret = 2;
+  }
+  queue.close();
+  return ret;
+}
+
+
+/*
+ * Regular files are mapped: no read system call per window
+ * and no copy through the stdio buffers.
+ *
+ * Compressed files are decompressed on a producer thread
+ */
+static int parse_mapped(
+    XML_Parser parser,
+    XMLParserCallback *tokenizer_callback,
+    int fd, size_t size,
+    std::atomic<uint64_t> *bytes_read) {
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) return -1;
+  madvise(map, size, MADV_SEQUENTIAL);
 
-    XML_ParserFree(parser);
-    fclose(fp);
+  const char *data = static_cast<const char*>(map);
+  int ret = -1;
+  auto compression = detect_compression(data, size);
+  if (compression == NONE && tokenizer_callback) {
+    OSMTokenizer tokenizer(*tokenizer_callback, bytes_read);
+    auto status = tokenizer.ParseDocument(data, size);
+    if (status == OSMTokenizer::DONE) {
+      ret = 0;
+    } else if (status == OSMTokenizer::FAILED) {
+      std::cerr << tokenizer.error() << " at offset " << tokenizer.offset();
+      ret = 2;
+    } else if (tokenizer.offset() > 0) {
+      ret = parse_resumed(*tokenizer_callback, tokenizer.root(), data, tokenizer.offset(), size, bytes_read);
+    }
+    /* else: rejected before the root element, expat parses it all */
+  }
+
+  if (ret != -1) {
+    /* parsed by the tokenizer */
+  } else if (compression == NONE) {
     ret = 0;
+    for (size_t offset = 0; offset < size; offset += window_size) {
+      auto len = std::min(window_size, size - offset);
+      if (!parse_window(parser, data + offset, len, offset + len == size)) {
+        ret = parse_error(parser);
+        break;
+      }
+      if (bytes_read) bytes_read->store(offset + len, std::memory_order_relaxed);
+    }
   } else {
+    osm2pgr::BufferQueue queue(queue_size, window_size);
+    std::thread producer(decompress_mapped, compression, data, size, std::ref(queue));
+    ret = parse_queue(parser, queue, bytes_read);
+    producer.join();
+  }
+  munmap(map, size);
+  return ret;
+}
+
+
+/*
+ * Reader thread for the inputs that can not be mapped (pipes, stdin):
+ * reading the next window overlaps with the parsing of the current one
+ */
+static void read_input(int fd, std::string head, osm2pgr::BufferQueue &queue) {
+  osm2pgr::Buffer buffer;
+  uint64_t offset = 0;
+  while (queue.acquire(buffer)) {
+    if (!head.empty()) {
+      memcpy(buffer.data.get(), head.data(), head.size());
+      buffer.size = head.size();
+      head.clear();
+    }
+    while (buffer.size < buffer.capacity) {
+      auto len = read(fd, buffer.data.get() + buffer.size, buffer.capacity - buffer.size);
+      if (len < 0 && errno == EINTR) continue;
+      if (len < 0) {
+        queue.fail(std::string("Error reading input: ") + strerror(errno));
+        return;
+      }
+      if (len == 0) break;
+      buffer.size += static_cast<size_t>(len);
+    }
+    offset += buffer.size;
+    buffer.input_offset = offset;
+    /* an empty buffer marks the end of the input */
+    auto done = buffer.size == 0;
+    queue.push(std::move(buffer));
+    if (done) return;
+  }
+}
+
+
+static int parse_stream(XML_Parser parser, int fd, std::atomic<uint64_t> *bytes_read) {
+  /*
+   * the first bytes tell if the input is compressed
+   */
+  char head[4];
+  size_t head_len = 0;
+  while (head_len < sizeof(head)) {
+    auto len = read(fd, head + head_len, sizeof(head) - head_len);
+    if (len < 0 && errno == EINTR) continue;
+    if (len <= 0) break;
+    head_len += static_cast<size_t>(len);
+  }
+  auto compression = detect_compression(head, head_len);
+
+  if (compression == NONE) {
+    osm2pgr::BufferQueue queue(2, window_size);
+    std::thread reader(read_input, fd, std::string(head, head_len), std::ref(queue));
+    auto ret = parse_queue(parser, queue, bytes_read);
+    reader.join();
+    return ret;
+  }
+
+  osm2pgr::BufferQueue queue(queue_size, window_size);
+  std::thread producer(decompress_stream, compression, fd, head, head_len, std::ref(queue));
+  auto ret = parse_queue(parser, queue, bytes_read);
+  producer.join();
+  return ret;
+}
+
+
+int XMLParser::Parse(
+    XMLParserCallback& rCallback,
+    const char* chFileName,
+    std::atomic<uint64_t> *bytes_read) {
+  bool is_stdin = strcmp(chFileName, "-") == 0;
+  int fd = is_stdin ? STDIN_FILENO : open(chFileName, O_RDONLY);
+  if (fd < 0) {
       std::cerr <<  "Error opening " << chFileName << ":" << strerror(errno);
+      return 1;  // File not found
   }
+
+  XML_Parser parser = XML_ParserCreate(NULL);
+
+  XML_SetUserData(parser, static_cast<void*>(&rCallback));
+
+  // register Callbacks for start- and end-element events of the parser:
+  XML_SetElementHandler(parser, startElement, endElement);
+
+  int ret = -1;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    ret = parse_mapped(
+        parser,
+        m_tokenizer ? &rCallback : nullptr,
+        fd, static_cast<size_t>(st.st_size),
+        bytes_read);
+  }
+  if (ret == -1) {
+    /* not a regular file or could not be mapped */
+    ret = parse_stream(parser, fd, bytes_read);
+  }
+
+  XML_ParserFree(parser);
+  if (!is_stdin) close(fd);
   return ret;  // return = 0 indicating success
 }
 
 
+/*
+ * [begin, end) of the comments, CDATA sections, processing instructions and
+ * declarations of a file: a "<node" in them does not start an element.
+ * '<' is neither in attribute values nor in text, every other '<' starts a tag.
+ */
+typedef std::vector<std::pair<size_t, size_t>> Spans;
+
+
+static size_t find(const char *data, size_t from, size_t end, const char *text) {
+  if (from >= end) return end;
+  auto found = memmem(data + from, end - from, text, strlen(text));
+  return found ? static_cast<size_t>(static_cast<const char*>(found) - data) : end;
+}
+
+
+static size_t find_end(const char *data, size_t from, size_t end, const char *text) {
+  auto found = find(data, from, end, text);
+  return found == end ? end : found + strlen(text);
+}
+
+
+static bool starts_with(const char *data, size_t offset, size_t end, const char *text) {
+  auto len = strlen(text);
+  return end - offset >= len && memcmp(data + offset, text, len) == 0;
+}
+
+
+static Spans markup_spans(const char *data, size_t size) {
+  Spans spans;
+  size_t from = 0;
+  auto bang = find(data, 0, size, "<!");
+  auto question = find(data, 0, size, "<?");
+  for (;;) {
+    if (bang < from) bang = find(data, from, size, "<!");
+    if (question < from) question = find(data, from, size, "<?");
+    auto start = std::min(bang, question);
+    if (start == size) break;
+
+    size_t stop;
+    if (start == question) {
+      stop = find_end(data, start + 2, size, "?>");
+    } else if (starts_with(data, start, size, "<!--")) {
+      stop = find_end(data, start + 4, size, "-->");
+    } else if (starts_with(data, start, size, "<![CDATA[")) {
+      stop = find_end(data, start + 9, size, "]]>");
+    } else {
+      /* <!DOCTYPE ...>, its internal subset in [ ] */
+      auto close = find(data, start, size, ">");
+      auto subset = find(data, start, close, "[");
+      stop = find_end(data, subset < close ? find(data, subset, size, "]") : close, size, ">");
+    }
+    spans.emplace_back(start, stop);
+    from = stop;
+  }
+  return spans;
+}
+
+
+/*
+ * the end of the span holding the offset, the offset when it is in none
+ */
+static size_t skip_span(const Spans &spans, size_t offset) {
+  auto next = std::upper_bound(spans.begin(), spans.end(), std::make_pair(offset, ~size_t(0)));
+  if (next == spans.begin()) return offset;
+  --next;
+  return next->second > offset ? next->second : offset;
+}
+
+
+/*
+ * A range of a parallel parse starts on one of these elements
+ */
+static bool is_range_start(const char *p, const char *end) {
+  static const char* names[] = {"node", "way", "relation"};
+  for (auto name : names) {
+    auto len = strlen(name);
+    if (static_cast<size_t>(end - p) > len + 1
+        && memcmp(p + 1, name, len) == 0
+        && (isspace(static_cast<unsigned char>(p[len + 1])) || p[len + 1] == '/' || p[len + 1] == '>')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+static size_t next_range_start(const char *data, size_t from, size_t end, const Spans &spans) {
+  while (from < end) {
+    auto found = static_cast<const char*>(memchr(data + from, '<', end - from));
+    if (!found) break;
+    auto offset = static_cast<size_t>(found - data);
+    auto skipped = skip_span(spans, offset);
+    if (skipped != offset) {
+      from = skipped;
+      continue;
+    }
+    if (is_range_start(found, data + end)) return offset;
+    from = offset + 1;
+  }
+  return end;
+}
+
+
+/*
+ * offset after the <osm ...> start tag, 0 when the root element is not osm
+ */
+static size_t content_begin(const char *data, size_t size, const Spans &spans) {
+  size_t from = 0;
+  while (from < size) {
+    auto found = static_cast<const char*>(memchr(data + from, '<', size - from));
+    if (!found) return 0;
+    auto offset = static_cast<size_t>(found - data);
+    auto skipped = skip_span(spans, offset);
+    if (skipped != offset) {
+      from = skipped;
+      continue;
+    }
+    if (!starts_with(data, offset, size, "<osm") || size - offset < 5
+        || !(isspace(static_cast<unsigned char>(data[offset + 4])) || data[offset + 4] == '>')) {
+      return 0;
+    }
+    /* a '>' can be in an attribute value */
+    char quote = 0;
+    for (auto i = offset + 4; i < size; ++i) {
+      if (quote) {
+        if (data[i] == quote) quote = 0;
+      } else if (data[i] == '"' || data[i] == '\'') {
+        quote = data[i];
+      } else if (data[i] == '>') {
+        return data[i - 1] == '/' ? 0 : i + 1;
+      }
+    }
+    return 0;
+  }
+  return 0;
+}
+
+
+/*
+ * offset of the closing </osm>, searched from the end of the file
+ */
+static size_t content_end(const char *data, size_t size, const Spans &spans) {
+  const char tag[] = "</osm";
+  const size_t len = sizeof(tag) - 1;
+  for (size_t i = size; i >= len; --i) {
+    if (memcmp(data + i - len, tag, len) == 0 && skip_span(spans, i - len) == i - len) return i - len;
+  }
+  return size;
+}
+
+
+/*
+ * parses the range as the content of an osm element
+ */
+static int parse_range(
+    XMLParserCallback *callback,
+    const char *data, size_t size,
+    bool use_tokenizer,
+    std::atomic<uint64_t> *bytes_read) {
+  static const char open_tag[] = "<osm>";
+  static const char close_tag[] = "</osm>";
+
+  if (use_tokenizer) {
+    OSMTokenizer tokenizer(*callback, bytes_read);
+    if (tokenizer.ParseContent(data, size) == OSMTokenizer::DONE) return 0;
+    /* expat parses what is left */
+    data += tokenizer.offset();
+    size -= tokenizer.offset();
+  }
+
+  XML_Parser parser = XML_ParserCreate(NULL);
+  XML_SetUserData(parser, static_cast<void*>(callback));
+  XML_SetElementHandler(parser, startElement, endElement);
+
+  bool ok = parse_window(parser, open_tag, sizeof(open_tag) - 1, false);
+  for (size_t offset = 0; ok && offset < size; offset += window_size) {
+    auto len = std::min(window_size, size - offset);
+    ok = parse_window(parser, data + offset, len, false);
+    if (ok && bytes_read) bytes_read->fetch_add(len, std::memory_order_relaxed);
+  }
+  ok = ok && parse_window(parser, close_tag, sizeof(close_tag) - 1, true);
+
+  /* not reported: the file is parsed again on one thread, which reports the error */
+  int ret = ok ? 0 : 2;
+  XML_ParserFree(parser);
+  return ret;
+}
+
+
+int XMLParser::ParseParallel(
+    const std::vector<XMLParserCallback*> &callbacks,
+    const char* chFileName,
+    std::atomic<uint64_t> *bytes_read) {
+  int fd = open(chFileName, O_RDONLY);
+  if (fd < 0) {
+      std::cerr <<  "Error opening " << chFileName << ":" << strerror(errno);
+      return 1;  // File not found
+  }
+
+  struct stat st;
+  if (callbacks.empty() || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return 3;
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    close(fd);
+    return 3;
+  }
+  const char *data = static_cast<const char*>(map);
+  if (detect_compression(data, size) != NONE) {
+    munmap(map, size);
+    close(fd);
+    return 3;
+  }
+
+  /*
+   * the cuts are moved forward to the next element out of the comments,
+   * the declaration, <osm ...> and <bounds> before the first one are skipped
+   */
+  auto spans = markup_spans(data, size);
+  auto content = content_begin(data, size, spans);
+  if (content == 0) {
+    munmap(map, size);
+    close(fd);
+    return 3;
+  }
+  auto begin = next_range_start(data, content, size, spans);
+  auto end = std::max(begin, content_end(data, size, spans));
+  auto ranges = callbacks.size();
+  std::vector<size_t> cuts(1, begin);
+  for (size_t i = 1; i < ranges; ++i) {
+    auto cut = next_range_start(data, begin + (end - begin) / ranges * i, end, spans);
+    cuts.push_back(std::max(cuts.back(), cut));
+  }
+  cuts.push_back(end);
+
+  int ret = 0;
+  {
+    osm2pgr::ThreadPool pool(ranges);
+    std::vector<std::future<int>> results;
+    for (size_t i = 0; i < ranges; ++i) {
+      auto callback = callbacks[i];
+      auto range_begin = cuts[i];
+      auto range_end = cuts[i + 1];
+      auto use_tokenizer = m_tokenizer;
+      results.push_back(pool.submit([callback, data, range_begin, range_end, use_tokenizer, bytes_read]() {
+            return parse_range(callback, data + range_begin, range_end - range_begin, use_tokenizer, bytes_read);}));
+    }
+    for (auto &result : results) {
+      auto range_ret = result.get();
+      if (ret == 0) ret = range_ret;
+    }
+  }
+  if (ret == 0 && bytes_read) bytes_read->store(size, std::memory_order_relaxed);
+
+  munmap(map, size);
+  close(fd);
+  return ret;
+}
 
 }  // end namespace xml
 //! \endcond
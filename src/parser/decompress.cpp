@@ -0,0 +1,525 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+#include "parser/decompress.h"
+
+#include <bzlib.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utilities/thread_pool.h"
+
+
+namespace xml {
+
+namespace {
+
+/*
+ * Size of the compressed pieces decompressed by one task
+ */
+const size_t min_piece_size = 4 * 1024 * 1024;
+
+/*
+ * Compressed bytes handed to a sequential decoder at once,
+ * small enough for a smooth input offset
+ */
+const size_t feed_size = 256 * 1024;
+
+/*
+ * raised on the producer when the consumer closed the queue
+ */
+struct Closed {};
+
+
+/*
+ * Destination of the decompressed data
+ */
+class Output {
+ public:
+     virtual ~Output() {}
+     //! free space to write into, never empty
+     virtual char* space(size_t &avail) = 0;
+     //! the first len bytes of the space are used
+     virtual void commit(size_t len) = 0;
+};
+
+
+class QueueOutput : public Output {
+ public:
+     explicit QueueOutput(osm2pgr::BufferQueue &queue) :
+         m_queue(queue),
+         m_has_buffer(false),
+         m_input_offset(0) {}
+
+     //! compressed bytes consumed once the data written so far is parsed
+     void input_offset(uint64_t offset) {m_input_offset = offset;}
+
+     char* space(size_t &avail) {
+         if (m_has_buffer && m_buffer.size == m_buffer.capacity) flush();
+         if (!m_has_buffer) {
+             if (!m_queue.acquire(m_buffer)) throw Closed();
+             m_has_buffer = true;
+         }
+         avail = m_buffer.capacity - m_buffer.size;
+         return m_buffer.data.get() + m_buffer.size;
+     }
+
+     void commit(size_t len) {m_buffer.size += len;}
+
+     void write(const char *data, size_t len) {
+         while (len) {
+             size_t avail;
+             auto dst = space(avail);
+             auto n = std::min(avail, len);
+             memcpy(dst, data, n);
+             commit(n);
+             data += n;
+             len -= n;
+         }
+     }
+
+     //! pushes the pending data and the end of input mark
+     void finish() {
+         flush();
+         if (!m_queue.acquire(m_buffer)) throw Closed();
+         m_buffer.input_offset = m_input_offset;
+         m_queue.push(std::move(m_buffer));
+     }
+
+ private:
+     void flush() {
+         if (m_has_buffer && m_buffer.size) {
+             m_buffer.input_offset = m_input_offset;
+             m_queue.push(std::move(m_buffer));
+             m_has_buffer = false;
+         }
+     }
+
+ private:
+     osm2pgr::BufferQueue &m_queue;
+     osm2pgr::Buffer m_buffer;
+     bool m_has_buffer;
+     uint64_t m_input_offset;
+};
+
+
+class StringOutput : public Output {
+ public:
+     StringOutput() : m_used(0) {}
+
+     char* space(size_t &avail) {
+         if (m_used == m_data.size()) {
+             m_data.resize(std::max(m_data.size() * 2, min_piece_size));
+         }
+         avail = m_data.size() - m_used;
+         return &m_data[m_used];
+     }
+
+     void commit(size_t len) {m_used += len;}
+
+     std::string result() {
+         m_data.resize(m_used);
+         return std::move(m_data);
+     }
+
+ private:
+     std::string m_data;
+     size_t m_used;
+};
+
+
+/*
+ * Streaming decoders, concatenated streams / members / frames
+ * are decoded as one input
+ */
+class Decoder {
+ public:
+     virtual ~Decoder() {}
+     //! decodes all the input
+     virtual void decode(const char *in, size_t len, Output &out) = 0;
+     //! true when the input ended in the middle of a stream
+     virtual bool incomplete() const = 0;
+};
+
+
+class GzipDecoder : public Decoder {
+ public:
+     GzipDecoder() :
+         m_in_stream(false) {
+         memset(&m_zs, 0, sizeof(m_zs));
+         /* 32: detect the gzip header */
+         if (inflateInit2(&m_zs, 15 + 32) != Z_OK) throw std::runtime_error("gzip: initialization failed");
+     }
+     ~GzipDecoder() {inflateEnd(&m_zs);}
+
+     void decode(const char *in, size_t len, Output &out) {
+         m_zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+         m_zs.avail_in = static_cast<uInt>(len);
+         while (true) {
+             size_t avail;
+             auto dst = out.space(avail);
+             m_zs.next_out = reinterpret_cast<Bytef*>(dst);
+             m_zs.avail_out = static_cast<uInt>(std::min(avail, static_cast<size_t>(UINT_MAX)));
+             auto before = m_zs.avail_out;
+             auto ret = inflate(&m_zs, Z_NO_FLUSH);
+             out.commit(before - m_zs.avail_out);
+
+             if (ret == Z_STREAM_END) {
+                 /* next member */
+                 inflateReset(&m_zs);
+                 m_in_stream = false;
+             } else if (ret == Z_OK || ret == Z_BUF_ERROR) {
+                 m_in_stream = true;
+             } else {
+                 throw std::runtime_error(std::string("gzip: ") + (m_zs.msg ? m_zs.msg : "corrupted input"));
+             }
+             if (m_zs.avail_in == 0 && m_zs.avail_out > 0) return;
+         }
+     }
+
+     bool incomplete() const {return m_in_stream;}
+
+ private:
+     z_stream m_zs;
+     bool m_in_stream;
+};
+
+
+class Bzip2Decoder : public Decoder {
+ public:
+     Bzip2Decoder() :
+         m_in_stream(false) {
+         init();
+     }
+     ~Bzip2Decoder() {BZ2_bzDecompressEnd(&m_bz);}
+
+     void decode(const char *in, size_t len, Output &out) {
+         m_bz.next_in = const_cast<char*>(in);
+         m_bz.avail_in = static_cast<unsigned int>(len);
+         while (true) {
+             size_t avail;
+             auto dst = out.space(avail);
+             m_bz.next_out = dst;
+             m_bz.avail_out = static_cast<unsigned int>(std::min(avail, static_cast<size_t>(UINT_MAX)));
+             auto before = m_bz.avail_out;
+             auto ret = BZ2_bzDecompress(&m_bz);
+             out.commit(before - m_bz.avail_out);
+
+             if (ret == BZ_STREAM_END) {
+                 /* next stream: the library has to be restarted */
+                 auto next_in = m_bz.next_in;
+                 auto avail_in = m_bz.avail_in;
+                 BZ2_bzDecompressEnd(&m_bz);
+                 init();
+                 m_bz.next_in = next_in;
+                 m_bz.avail_in = avail_in;
+                 m_in_stream = false;
+                 if (avail_in == 0) return;
+             } else if (ret == BZ_OK) {
+                 m_in_stream = true;
+                 if (m_bz.avail_in == 0 && m_bz.avail_out > 0) return;
+             } else {
+                 throw std::runtime_error("bzip2: corrupted input, error " + std::to_string(ret));
+             }
+         }
+     }
+
+     bool incomplete() const {return m_in_stream;}
+
+ private:
+     void init() {
+         memset(&m_bz, 0, sizeof(m_bz));
+         if (BZ2_bzDecompressInit(&m_bz, 0, 0) != BZ_OK) throw std::runtime_error("bzip2: initialization failed");
+     }
+
+ private:
+     bz_stream m_bz;
+     bool m_in_stream;
+};
+
+
+#ifdef HAVE_ZSTD
+class ZstdDecoder : public Decoder {
+ public:
+     ZstdDecoder() :
+         m_ctx(ZSTD_createDCtx()),
+         m_in_frame(false) {
+         if (!m_ctx) throw std::runtime_error("zstd: initialization failed");
+     }
+     ~ZstdDecoder() {ZSTD_freeDCtx(m_ctx);}
+
+     void decode(const char *in, size_t len, Output &out) {
+         ZSTD_inBuffer input = {in, len, 0};
+         while (true) {
+             size_t avail;
+             auto dst = out.space(avail);
+             ZSTD_outBuffer output = {dst, avail, 0};
+             auto ret = ZSTD_decompressStream(m_ctx, &output, &input);
+             if (ZSTD_isError(ret)) throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(ret));
+             out.commit(output.pos);
+             m_in_frame = ret != 0;
+             if (input.pos == input.size && output.pos < output.size) return;
+         }
+     }
+
+     bool incomplete() const {return m_in_frame;}
+
+ private:
+     ZSTD_DCtx *m_ctx;
+     bool m_in_frame;
+};
+#endif
+
+
+std::unique_ptr<Decoder>
+make_decoder(Compression compression) {
+    switch (compression) {
+        case GZIP: return std::unique_ptr<Decoder>(new GzipDecoder());
+        case BZIP2: return std::unique_ptr<Decoder>(new Bzip2Decoder());
+#ifdef HAVE_ZSTD
+        case ZSTD: return std::unique_ptr<Decoder>(new ZstdDecoder());
+#else
+        case ZSTD: throw std::runtime_error("zstd input is not supported by this build");
+#endif
+        default: throw std::runtime_error("unknown compression");
+    }
+}
+
+
+/*
+ * bzip2 stream start: "BZh" + block size + block magic (pi)
+ */
+bool
+is_bzip2_stream(const char *data) {
+    return data[0] == 'B' && data[1] == 'Z' && data[2] == 'h'
+        && data[3] >= '1' && data[3] <= '9'
+        && memcmp(data + 4, "\x31\x41\x59\x26\x53\x59", 6) == 0;
+}
+
+
+/*
+ * Offsets where independent pieces start, the last one is the size.
+ *
+ * A bzip2 stream start can appear by chance inside a stream,
+ * such a split is detected when decompressing and the rest of the
+ * input is decompressed sequentially.
+ */
+std::vector<size_t>
+split_pieces(Compression compression, const char *data, size_t size) {
+    std::vector<size_t> starts(1, 0);
+    if (compression == BZIP2) {
+        const size_t pattern_len = 10;
+        for (size_t i = min_piece_size; i + pattern_len <= size; ++i) {
+            auto found = static_cast<const char*>(memchr(data + i, 'B', size - i - pattern_len + 1));
+            if (!found) break;
+            i = static_cast<size_t>(found - data);
+            if (is_bzip2_stream(found)) {
+                starts.push_back(i);
+                i += min_piece_size - 1;
+            }
+        }
+    }
+#ifdef HAVE_ZSTD
+    if (compression == ZSTD) {
+        size_t offset = 0;
+        size_t piece_start = 0;
+        while (offset < size) {
+            auto frame_size = ZSTD_findFrameCompressedSize(data + offset, size - offset);
+            if (ZSTD_isError(frame_size)) break;  // reported by the decoder
+            offset += frame_size;
+            if (offset < size && offset - piece_start >= min_piece_size) {
+                starts.push_back(offset);
+                piece_start = offset;
+            }
+        }
+    }
+#endif
+    starts.push_back(size);
+    return starts;
+}
+
+
+std::string
+decompress_piece(Compression compression, const char *data, size_t size) {
+    auto decoder = make_decoder(compression);
+    StringOutput out;
+    decoder->decode(data, size, out);
+    if (decoder->incomplete()) throw std::runtime_error("incomplete piece");
+    return out.result();
+}
+
+
+void
+decompress_sequential(
+        Compression compression,
+        const char *data, size_t size,
+        uint64_t offset,
+        QueueOutput &out) {
+    auto decoder = make_decoder(compression);
+    while (size) {
+        /* fed in pieces so the output is pushed as it is produced */
+        auto len = std::min(size, feed_size);
+        offset += len;
+        out.input_offset(offset);
+        decoder->decode(data, len, out);
+        data += len;
+        size -= len;
+    }
+    if (decoder->incomplete()) throw std::runtime_error(std::string(compression_name(compression)) + ": unexpected end of input");
+}
+
+
+void
+decompress_parallel(
+        Compression compression,
+        const char *data,
+        const std::vector<size_t> &starts,
+        QueueOutput &out) {
+    osm2pgr::ThreadPool pool;
+    /* piece number and its decompressed text */
+    std::deque<std::pair<size_t, std::future<std::string>>> pending;
+    const size_t max_pending = 2 * pool.size();
+
+    size_t next = 0;
+    while (next + 1 < starts.size() || !pending.empty()) {
+        while (next + 1 < starts.size() && pending.size() < max_pending) {
+            auto begin = starts[next];
+            auto end = starts[next + 1];
+            pending.emplace_back(next, pool.submit([compression, data, begin, end]() {
+                        return decompress_piece(compression, data + begin, end - begin);}));
+            ++next;
+        }
+
+        auto piece = pending.front().first;
+        std::string text;
+        try {
+            text = pending.front().second.get();
+        } catch (const std::exception &) {
+            /*
+             * bad split: the rest is decompressed sequentially
+             */
+            auto begin = starts[piece];
+            decompress_sequential(compression, data + begin, starts.back() - begin, begin, out);
+            return;
+        }
+        pending.pop_front();
+        out.input_offset(starts[piece + 1]);
+        out.write(text.data(), text.size());
+    }
+}
+
+}  // namespace
+
+
+
+Compression
+detect_compression(const char *data, size_t len) {
+    auto bytes = reinterpret_cast<const unsigned char*>(data);
+    if (len >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) return GZIP;
+    if (len >= 3 && bytes[0] == 'B' && bytes[1] == 'Z' && bytes[2] == 'h') return BZIP2;
+    if (len >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd) return ZSTD;
+    return NONE;
+}
+
+
+const char*
+compression_name(Compression compression) {
+    switch (compression) {
+        case GZIP: return "gzip";
+        case BZIP2: return "bzip2";
+        case ZSTD: return "zstd";
+        default: return "none";
+    }
+}
+
+
+void
+decompress_mapped(
+        Compression compression,
+        const char *data, size_t size,
+        osm2pgr::BufferQueue &queue) {
+    QueueOutput out(queue);
+    try {
+        auto starts = split_pieces(compression, data, size);
+        if (starts.size() > 2) {
+            decompress_parallel(compression, data, starts, out);
+        } else {
+            decompress_sequential(compression, data, size, 0, out);
+        }
+        out.finish();
+    } catch (const Closed &) {
+        return;
+    } catch (const std::exception &e) {
+        queue.fail(e.what());
+    }
+}
+
+
+void
+decompress_stream(
+        Compression compression,
+        int fd,
+        const char *head, size_t head_len,
+        osm2pgr::BufferQueue &queue) {
+    QueueOutput out(queue);
+    try {
+        auto decoder = make_decoder(compression);
+        uint64_t offset = head_len;
+        out.input_offset(offset);
+        decoder->decode(head, head_len, out);
+
+        std::vector<char> in(min_piece_size);
+        while (true) {
+            auto len = read(fd, in.data(), in.size());
+            if (len < 0 && errno == EINTR) continue;
+            if (len < 0) throw std::runtime_error(std::string("Error reading input: ") + strerror(errno));
+            if (len == 0) break;
+            offset += static_cast<uint64_t>(len);
+            out.input_offset(offset);
+            decoder->decode(in.data(), static_cast<size_t>(len), out);
+        }
+        if (decoder->incomplete()) throw std::runtime_error(std::string(compression_name(compression)) + ": unexpected end of input");
+        out.finish();
+    } catch (const Closed &) {
+        return;
+    } catch (const std::exception &e) {
+        queue.fail(e.what());
+    }
+}
+
+}  // end namespace xml
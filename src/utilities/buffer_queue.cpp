@@ -0,0 +1,99 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+#include "utilities/buffer_queue.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace osm2pgr {
+
+BufferQueue::BufferQueue(size_t buffers, size_t buffer_size) :
+    m_closed(false) {
+        for (size_t i = 0; i < buffers; ++i) {
+            m_empty.emplace_back(buffer_size);
+        }
+    }
+
+
+bool
+BufferQueue::acquire(Buffer &buffer) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] {return m_closed || !m_empty.empty();});
+    if (m_closed) return false;
+    buffer = std::move(m_empty.front());
+    m_empty.pop_front();
+    buffer.size = 0;
+    buffer.input_offset = 0;
+    return true;
+}
+
+
+void
+BufferQueue::push(Buffer buffer) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_filled.push_back(std::move(buffer));
+    }
+    m_cv.notify_all();
+}
+
+
+void
+BufferQueue::fail(const std::string &message) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_error = message.empty() ? "unknown input error" : message;
+    }
+    m_cv.notify_all();
+}
+
+
+bool
+BufferQueue::pop(Buffer &buffer) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] {return !m_error.empty() || !m_filled.empty();});
+    if (!m_error.empty()) throw std::runtime_error(m_error);
+    buffer = std::move(m_filled.front());
+    m_filled.pop_front();
+    return buffer.size != 0;
+}
+
+
+void
+BufferQueue::release(Buffer buffer) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_empty.push_back(std::move(buffer));
+    }
+    m_cv.notify_all();
+}
+
+
+void
+BufferQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_cv.notify_all();
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,408 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+#include "utilities/copy_buffer.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+namespace osm2pgr {
+
+namespace {
+
+//! EWKB type flag: a SRID follows the type
+const uint32_t ewkb_srid = 0x20000000;
+const uint32_t wkb_point = 1;
+const uint32_t wkb_linestring = 2;
+const uint32_t srid = 4326;
+
+//! byte order, type, SRID
+const size_t ewkb_header = 1 + 4 + 4;
+
+
+inline bool
+needs_escape(char c) {
+    return c == '\\' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/*
+ * First byte that COPY text needs escaped: backslash, tab, newline, carriage return
+ */
+const char*
+find_escape(const char *p, const char *end) {
+#ifdef __SSE2__
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i tabs = _mm_set1_epi8('\t');
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const __m128i returns = _mm_set1_epi8('\r');
+    while (end - p >= 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto hits = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, backslashes), _mm_cmpeq_epi8(block, tabs)),
+                _mm_or_si128(_mm_cmpeq_epi8(block, newlines), _mm_cmpeq_epi8(block, returns)));
+        auto mask = _mm_movemask_epi8(hits);
+        if (mask) return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+#endif
+    while (p != end && !needs_escape(*p)) ++p;
+    return p;
+}
+
+}  // namespace
+
+
+void
+CopyBuffer::put16(uint16_t value) {
+    char bytes[2] = {
+        static_cast<char>(value >> 8),
+        static_cast<char>(value)};
+    m_data.append(bytes, 2);
+}
+
+void
+CopyBuffer::put32(uint32_t value) {
+    char bytes[4];
+    for (int i = 3; i >= 0; --i, value >>= 8) bytes[i] = static_cast<char>(value);
+    m_data.append(bytes, 4);
+}
+
+void
+CopyBuffer::put64(uint64_t value) {
+    char bytes[8];
+    for (int i = 7; i >= 0; --i, value >>= 8) bytes[i] = static_cast<char>(value);
+    m_data.append(bytes, 8);
+}
+
+
+void
+CopyBuffer::end_field() {
+    m_data.push_back(--m_fields ? '\t' : '\n');
+}
+
+void
+CopyBuffer::decimal(int64_t value) {
+    char buffer[24];
+    char *p = buffer + sizeof(buffer);
+    auto magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    m_data.append(p, static_cast<size_t>(buffer + sizeof(buffer) - p));
+}
+
+/*
+ * 1e-7 degrees as decimal degrees without trailing zeros, like Node::fixed_str
+ */
+void
+CopyBuffer::fixed(int32_t value) {
+    auto magnitude = value < 0 ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    if (value < 0) m_data.push_back('-');
+    decimal(magnitude / 10000000);
+    auto fraction = magnitude % 10000000;
+    if (!fraction) return;
+    char digits[8] = {'.'};
+    for (int i = 7; i > 0; --i, fraction /= 10) digits[i] = static_cast<char>('0' + fraction % 10);
+    size_t len = 8;
+    while (digits[len - 1] == '0') --len;
+    m_data.append(digits, len);
+}
+
+void
+CopyBuffer::escaped(const char *text, size_t size) {
+    auto end = text + size;
+    for (auto p = find_escape(text, end); p != end; p = find_escape(text, end)) {
+        m_data.append(text, static_cast<size_t>(p - text));
+        m_data.push_back('\\');
+        switch (*p) {
+            case '\t': m_data.push_back('t'); break;
+            case '\n': m_data.push_back('n'); break;
+            case '\r': m_data.push_back('r'); break;
+            default: m_data.push_back('\\');
+        }
+        text = p + 1;
+    }
+    m_data.append(text, static_cast<size_t>(end - text));
+}
+
+/*
+ * hstore text: double quotes and backslashes are backslash escaped,
+ * then the whole is escaped for COPY
+ */
+void
+CopyBuffer::hstore_quoted(const std::string &text) {
+    m_data.push_back('"');
+    for (auto c : text) {
+        if (c == '"' || c == '\\') m_data.append("\\\\");
+        escaped(&c, 1);
+    }
+    m_data.push_back('"');
+}
+
+
+void
+CopyBuffer::header() {
+    if (!m_binary) return;
+    m_data.append("PGCOPY\n\377\r\n\0", 11);
+    /* flags, header extension length */
+    put32(0);
+    put32(0);
+}
+
+void
+CopyBuffer::trailer() {
+    if (!m_binary) return;
+    put16(0xffff);
+}
+
+void
+CopyBuffer::row(size_t fields) {
+    if (m_binary) {
+        put16(static_cast<uint16_t>(fields));
+    } else {
+        m_fields = fields;
+    }
+}
+
+
+void
+CopyBuffer::null() {
+    if (m_binary) {
+        put32(0xffffffff);
+        return;
+    }
+    m_data.append("\\N");
+    end_field();
+}
+
+void
+CopyBuffer::boolean(bool value) {
+    if (m_binary) {
+        put32(1);
+        m_data.push_back(value ? 1 : 0);
+        return;
+    }
+    m_data.push_back(value ? 't' : 'f');
+    end_field();
+}
+
+void
+CopyBuffer::int4(int32_t value) {
+    if (m_binary) {
+        put32(4);
+        put32(static_cast<uint32_t>(value));
+        return;
+    }
+    decimal(value);
+    end_field();
+}
+
+void
+CopyBuffer::int8(int64_t value) {
+    if (m_binary) {
+        put32(8);
+        put64(static_cast<uint64_t>(value));
+        return;
+    }
+    decimal(value);
+    end_field();
+}
+
+void
+CopyBuffer::float8(double value) {
+    if (m_binary) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        put32(8);
+        put64(bits);
+        return;
+    }
+    /* the digits of boost::lexical_cast, that read back to the same double */
+    char buffer[32];
+    auto len = snprintf(buffer, sizeof(buffer), "%.17g", value);
+    m_data.append(buffer, static_cast<size_t>(len));
+    end_field();
+}
+
+void
+CopyBuffer::degrees(int32_t value) {
+    if (m_binary) {
+        float8(value / 1e7);
+        return;
+    }
+    fixed(value);
+    end_field();
+}
+
+/*
+ * numeric_recv: number of base 10000 digits, weight of the first one,
+ * sign, display scale, digits
+ * 1e-7 degrees are the integer part and 2 digits of fraction:
+ * ddd.dddd|ddd0
+ */
+void
+CopyBuffer::numeric(int32_t value) {
+    if (!m_binary) {
+        fixed(value);
+        end_field();
+        return;
+    }
+    auto magnitude = value < 0 ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    auto fraction = magnitude % 10000000 * 10;
+    put32(8 + 3 * 2);
+    put16(3);
+    put16(0);
+    put16(value < 0 ? 0x4000 : 0x0000);
+    put16(7);
+    put16(static_cast<uint16_t>(magnitude / 10000000));
+    put16(static_cast<uint16_t>(fraction / 10000));
+    put16(static_cast<uint16_t>(fraction % 10000));
+}
+
+void
+CopyBuffer::text(const std::string &value) {
+    if (value.empty()) {
+        null();
+        return;
+    }
+    if (m_binary) {
+        put32(static_cast<uint32_t>(value.size()));
+        m_data.append(value);
+        return;
+    }
+    escaped(value.data(), value.size());
+    end_field();
+}
+
+/*
+ * hstore_recv: number of pairs, then length & bytes of each key and value,
+ * the server sorts the pairs and removes the duplicated keys
+ */
+void
+CopyBuffer::hstore(const std::map<std::string, std::string> &values) {
+    if (values.empty()) {
+        null();
+        return;
+    }
+    if (!m_binary) {
+        bool first = true;
+        for (const auto &item : values) {
+            if (!first) m_data.push_back(',');
+            first = false;
+            hstore_quoted(item.first);
+            m_data.append("=>");
+            hstore_quoted(item.second);
+        }
+        end_field();
+        return;
+    }
+    size_t length = 4;
+    for (const auto &item : values) {
+        length += 8 + item.first.size() + item.second.size();
+    }
+    put32(static_cast<uint32_t>(length));
+    put32(static_cast<uint32_t>(values.size()));
+    for (const auto &item : values) {
+        put32(static_cast<uint32_t>(item.first.size()));
+        m_data.append(item.first);
+        put32(static_cast<uint32_t>(item.second.size()));
+        m_data.append(item.second);
+    }
+}
+
+
+/*
+ * big endian EWKB, like the rest of the row
+ */
+void
+CopyBuffer::ewkb(uint32_t type) {
+    m_data.push_back('\0');
+    put32(type | ewkb_srid);
+    put32(srid);
+}
+
+void
+CopyBuffer::point(int32_t lon, int32_t lat) {
+    if (m_binary) {
+        put32(static_cast<uint32_t>(ewkb_header + 16));
+        ewkb(wkb_point);
+    } else {
+        m_data.append("SRID=4326;POINT(");
+        m_points = 1;
+    }
+    coordinate(lon, lat);
+}
+
+void
+CopyBuffer::linestring(size_t points) {
+    if (m_binary) {
+        put32(static_cast<uint32_t>(ewkb_header + 4 + 16 * points));
+        ewkb(wkb_linestring);
+        put32(static_cast<uint32_t>(points));
+        return;
+    }
+    if (points == 0) {
+        m_data.append("SRID=4326;LINESTRING EMPTY");
+        end_field();
+        return;
+    }
+    m_data.append("SRID=4326;LINESTRING(");
+    m_points = points;
+}
+
+void
+CopyBuffer::coordinate(int32_t lon, int32_t lat) {
+    if (!m_binary) {
+        fixed(lon);
+        m_data.push_back(' ');
+        fixed(lat);
+        if (--m_points) {
+            m_data.append(", ");
+        } else {
+            m_data.push_back(')');
+            end_field();
+        }
+        return;
+    }
+    /* n / 1e7 is the double nearest to the decimal text "d.ddddddd" */
+    double x = lon / 1e7;
+    double y = lat / 1e7;
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    put64(bits);
+    memcpy(&bits, &y, sizeof(bits));
+    put64(bits);
+}
+
+
+std::string
+CopyBuffer::release() {
+    std::string rows;
+    rows.swap(m_data);
+    return rows;
+}
+
+}  // namespace osm2pgr
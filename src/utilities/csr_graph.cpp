@@ -0,0 +1,249 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+#include "utilities/csr_graph.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace osm2pgr {
+
+namespace {
+
+const char magic[8] = "o2p-csr";
+const uint32_t byte_order = 0x01020304;
+const uint64_t alignment = 64;
+
+static_assert(sizeof(CsrGraph::Header) == 128, "the header is 128 bytes on the file");
+
+std::runtime_error
+csr_error(const std::string &what, const std::string &file_name) {
+    return std::runtime_error("CSR graph " + file_name + ": " + what + ": " + strerror(errno));
+}
+
+uint64_t aligned(uint64_t offset) {return (offset + alignment - 1) / alignment * alignment;}
+
+struct Vertex {
+    int64_t id;
+    int32_t lon;
+    int32_t lat;
+};
+
+}  // namespace
+
+
+CsrGraph::Header
+CsrGraph::write(const std::string &file_name, const std::vector<Edge> &edges) {
+    /*
+     * the vertices, in the order of their ids
+     */
+    std::vector<Vertex> vertices;
+    vertices.reserve(2 * edges.size());
+    for (const auto &edge : edges) {
+        vertices.push_back(Vertex{edge.source, edge.source_lon, edge.source_lat});
+        vertices.push_back(Vertex{edge.target, edge.target_lon, edge.target_lat});
+    }
+    std::sort(vertices.begin(), vertices.end(), [](const Vertex &a, const Vertex &b) {return a.id < b.id;});
+    vertices.erase(std::unique(vertices.begin(), vertices.end(),
+                [](const Vertex &a, const Vertex &b) {return a.id == b.id;}), vertices.end());
+
+    if (vertices.size() > UINT32_MAX || 2 * edges.size() > UINT32_MAX) {
+        errno = EOVERFLOW;
+        throw csr_error("too many vertices or edges", file_name);
+    }
+
+    auto index = [&vertices](int64_t id) {
+        auto found = std::lower_bound(vertices.begin(), vertices.end(), id,
+                [](const Vertex &vertex, int64_t value) {return vertex.id < value;});
+        return static_cast<uint32_t>(found - vertices.begin());
+    };
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.byte_order = byte_order;
+    header.vertices = vertices.size();
+    header.edges = edges.size();
+    header.arcs = 2 * edges.size();
+
+    /*
+     * counting sort of the arcs by vertex, in the order of the edges
+     */
+    std::vector<uint32_t> sources(edges.size());
+    std::vector<uint32_t> targets(edges.size());
+    std::vector<uint64_t> offsets(vertices.size() + 1, 0);
+    for (size_t e = 0; e < edges.size(); ++e) {
+        sources[e] = index(edges[e].source);
+        targets[e] = index(edges[e].target);
+        ++offsets[sources[e] + 1];
+        ++offsets[targets[e] + 1];
+    }
+    for (size_t v = 0; v < vertices.size(); ++v) offsets[v + 1] += offsets[v];
+
+    std::vector<uint32_t> arc_targets(header.arcs);
+    std::vector<double> costs(header.arcs);
+    std::vector<double> reverse_costs(header.arcs);
+    std::vector<uint32_t> arc_edges(header.arcs);
+    std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t e = 0; e < edges.size(); ++e) {
+        auto arc = next[sources[e]]++;
+        arc_targets[arc] = targets[e];
+        costs[arc] = edges[e].cost;
+        reverse_costs[arc] = edges[e].reverse_cost;
+        arc_edges[arc] = static_cast<uint32_t>(e);
+
+        arc = next[targets[e]]++;
+        arc_targets[arc] = sources[e];
+        costs[arc] = edges[e].reverse_cost;
+        reverse_costs[arc] = edges[e].cost;
+        arc_edges[arc] = static_cast<uint32_t>(e);
+    }
+    std::vector<uint32_t>().swap(sources);
+    std::vector<uint32_t>().swap(targets);
+
+    std::vector<int64_t> vertex_ids(vertices.size());
+    std::vector<double> lon(vertices.size());
+    std::vector<double> lat(vertices.size());
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        vertex_ids[v] = vertices[v].id;
+        lon[v] = vertices[v].lon / 1e7;
+        lat[v] = vertices[v].lat / 1e7;
+    }
+    std::vector<int64_t> gids(edges.size());
+    for (size_t e = 0; e < edges.size(); ++e) gids[e] = edges[e].gid;
+
+    /*
+     * the arrays, in the order of the header
+     */
+    struct Section {
+        uint64_t *offset;
+        const void *data;
+        uint64_t bytes;
+    };
+    const Section sections[] = {
+        {&header.offsets, offsets.data(), offsets.size() * sizeof(uint64_t)},
+        {&header.targets, arc_targets.data(), arc_targets.size() * sizeof(uint32_t)},
+        {&header.costs, costs.data(), costs.size() * sizeof(double)},
+        {&header.reverse_costs, reverse_costs.data(), reverse_costs.size() * sizeof(double)},
+        {&header.arc_edges, arc_edges.data(), arc_edges.size() * sizeof(uint32_t)},
+        {&header.vertex_ids, vertex_ids.data(), vertex_ids.size() * sizeof(int64_t)},
+        {&header.lon, lon.data(), lon.size() * sizeof(double)},
+        {&header.lat, lat.data(), lat.size() * sizeof(double)},
+        {&header.gids, gids.data(), gids.size() * sizeof(int64_t)}};
+    uint64_t size = sizeof(header);
+    for (const auto &section : sections) {
+        *section.offset = aligned(size);
+        size = *section.offset + section.bytes;
+    }
+    header.file_size = size;
+
+    auto temp_name = file_name + ".tmp";
+    auto file = fopen(temp_name.c_str(), "wb");
+    if (!file) throw csr_error("open", temp_name);
+
+    const char zeros[alignment] = {};
+    uint64_t written = 0;
+    auto put = [&](const void *data, uint64_t bytes) {
+        return fwrite(data, 1, bytes, file) == bytes;
+    };
+    bool ok = put(&header, sizeof(header));
+    written = sizeof(header);
+    for (const auto &section : sections) {
+        ok = ok && put(zeros, *section.offset - written) && put(section.data, section.bytes);
+        written = *section.offset + section.bytes;
+    }
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        auto error = csr_error("write", temp_name);
+        unlink(temp_name.c_str());
+        throw error;
+    }
+    if (rename(temp_name.c_str(), file_name.c_str()) != 0) throw csr_error("rename", temp_name);
+    return header;
+}
+
+
+CsrFile::CsrFile(const std::string &file_name) :
+    m_map(nullptr),
+    m_size(0) {
+        auto fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) throw csr_error("open", file_name);
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw csr_error("stat", file_name);
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size < sizeof(CsrGraph::Header)) {
+            close(fd);
+            errno = EINVAL;
+            throw csr_error("too short", file_name);
+        }
+
+        auto map = mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) throw csr_error("mmap", file_name);
+        m_map = static_cast<const char*>(map);
+
+        /*
+         * the arrays are checked to be on the file, not their contents
+         */
+        const auto &h = header();
+        auto inside = [&h](uint64_t offset, uint64_t count, uint64_t size) {
+            return offset % alignment == 0 && offset <= h.file_size && count <= (h.file_size - offset) / size;
+        };
+        bool valid = memcmp(h.magic, magic, sizeof(magic)) == 0
+            && h.version == CsrGraph::version
+            && h.byte_order == byte_order
+            && h.file_size == m_size
+            && h.arcs == 2 * h.edges
+            && inside(h.offsets, h.vertices + 1, sizeof(uint64_t))
+            && inside(h.targets, h.arcs, sizeof(uint32_t))
+            && inside(h.costs, h.arcs, sizeof(double))
+            && inside(h.reverse_costs, h.arcs, sizeof(double))
+            && inside(h.arc_edges, h.arcs, sizeof(uint32_t))
+            && inside(h.vertex_ids, h.vertices, sizeof(int64_t))
+            && inside(h.lon, h.vertices, sizeof(double))
+            && inside(h.lat, h.vertices, sizeof(double))
+            && inside(h.gids, h.edges, sizeof(int64_t));
+        if (!valid) {
+            munmap(const_cast<char*>(m_map), m_size);
+            errno = EINVAL;
+            throw csr_error("not a version " + std::to_string(CsrGraph::version) + " graph of this byte order", file_name);
+        }
+    }
+
+
+CsrFile::~CsrFile() {
+    munmap(const_cast<char*>(m_map), m_size);
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,111 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+#include "utilities/export_queue.h"
+
+#include <exception>
+#include <iostream>
+#include <utility>
+
+namespace osm2pgr {
+
+ExportQueue::ExportQueue(size_t writers, size_t capacity) :
+    m_writers(writers ? writers : 1),
+    m_capacity(capacity ? capacity : 1),
+    m_done(false),
+    m_tasks(0),
+    m_producer_wait(0),
+    m_writers_busy(0),
+    m_elapsed(0) {
+    }
+
+
+ExportQueue::~ExportQueue() {
+    finish();
+}
+
+
+void
+ExportQueue::push(Task task) {
+    if (m_threads.empty()) {
+        m_start = std::chrono::steady_clock::now();
+        m_done = false;
+        for (size_t i = 0; i < m_writers; ++i) {
+            m_threads.emplace_back(&ExportQueue::work, this);
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queue.size() >= m_capacity) {
+            auto begin = std::chrono::steady_clock::now();
+            m_not_full.wait(lock, [this] {return m_queue.size() < m_capacity;});
+            m_producer_wait += std::chrono::steady_clock::now() - begin;
+        }
+        m_queue.push_back(std::move(task));
+    }
+    m_not_empty.notify_one();
+}
+
+
+void
+ExportQueue::finish() {
+    if (m_threads.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+    }
+    m_not_empty.notify_all();
+    for (auto &thread : m_threads) thread.join();
+    m_threads.clear();
+    m_elapsed += std::chrono::steady_clock::now() - m_start;
+}
+
+
+/*
+ * the export methods report their own errors,
+ * anything else is reported here and the writer goes on
+ */
+void
+ExportQueue::work() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_empty.wait(lock, [this] {return m_done || !m_queue.empty();});
+            if (m_queue.empty()) return;
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_not_full.notify_one();
+
+        auto begin = std::chrono::steady_clock::now();
+        try {
+            task();
+        } catch (const std::exception &e) {
+            std::cerr << "\n" << e.what() << std::endl;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writers_busy += std::chrono::steady_clock::now() - begin;
+        ++m_tasks;
+    }
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,229 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+#include "utilities/flat_nodes.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace osm2pgr {
+
+/*
+ * first page of the file
+ */
+struct FlatNodes::Header {
+    char magic[16];
+    uint64_t input_size;
+    int64_t input_mtime;
+    uint64_t complete;
+};
+
+
+namespace {
+
+const char magic[16] = "osm2pgr-flat-1";
+const size_t header_size = 4096;
+const uint64_t min_slots = uint64_t(1) << 20;
+
+/*
+ * The empty slots read as zeros: the sign bit of the stored values is
+ * flipped, an all zero slot would be lat = lon = INT32_MIN
+ */
+const uint32_t flip = 0x80000000u;
+
+uint32_t encode(int32_t value) {return static_cast<uint32_t>(value) ^ flip;}
+int32_t decode(uint32_t value) {return static_cast<int32_t>(value ^ flip);}
+
+std::runtime_error
+flat_error(const std::string &what, const std::string &file_name) {
+    return std::runtime_error("Flat nodes " + file_name + ": " + what + ": " + strerror(errno));
+}
+
+}  // namespace
+
+
+FlatNodes::FlatNodes(const std::string &file_name, uint64_t input_size, int64_t input_mtime) :
+    m_file_name(file_name),
+    m_fd(-1),
+    m_map(nullptr),
+    m_slots(0),
+    m_reused(false),
+    m_uses(nullptr),
+    m_uses_capacity(0) {
+        m_fd = open(file_name.c_str(), O_RDWR | O_CREAT, 0644);
+        if (m_fd < 0) throw flat_error("open", file_name);
+
+        struct stat st;
+        if (fstat(m_fd, &st) != 0) throw flat_error("stat", file_name);
+        auto file_size = static_cast<uint64_t>(st.st_size);
+
+        Header header;
+        bool valid = file_size >= header_size
+            && pread(m_fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+            && memcmp(header.magic, magic, sizeof(magic)) == 0;
+        m_reused = valid
+            && input_size != 0
+            && header.complete
+            && header.input_size == input_size
+            && header.input_mtime == input_mtime;
+
+        /* the slots of another input would be read as nodes of this one */
+        if (!m_reused && ftruncate(m_fd, 0) != 0) throw flat_error("truncate", file_name);
+        m_slots = m_reused ? (file_size - header_size) / sizeof(uint64_t) : 0;
+        if (m_slots < min_slots) {
+            if (ftruncate(m_fd, static_cast<off_t>(header_size + min_slots * sizeof(uint64_t))) != 0) {
+                throw flat_error("resize", file_name);
+            }
+            m_slots = min_slots;
+        }
+
+        auto map = mmap(NULL, header_size + m_slots * sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (map == MAP_FAILED) throw flat_error("mmap", file_name);
+        m_map = static_cast<char*>(map);
+
+        /*
+         * until complete() the file does not match any input
+         */
+        auto mapped = reinterpret_cast<Header*>(m_map);
+        if (!m_reused) {
+            memcpy(mapped->magic, magic, sizeof(magic));
+            mapped->input_size = input_size;
+            mapped->input_mtime = input_mtime;
+            mapped->complete = 0;
+        }
+    }
+
+
+FlatNodes::~FlatNodes() {
+    if (m_uses) munmap(m_uses, m_uses_capacity);
+    if (m_map) munmap(m_map, header_size + m_slots * sizeof(uint64_t));
+    if (m_fd >= 0) close(m_fd);
+}
+
+
+void
+FlatNodes::grow_file(uint64_t slots) {
+    auto capacity = m_slots;
+    while (capacity < slots) capacity *= 2;
+    if (ftruncate(m_fd, static_cast<off_t>(header_size + capacity * sizeof(uint64_t))) != 0) {
+        throw flat_error("resize", m_file_name);
+    }
+    auto map = mremap(m_map,
+            header_size + m_slots * sizeof(uint64_t),
+            header_size + capacity * sizeof(uint64_t),
+            MREMAP_MAYMOVE);
+    if (map == MAP_FAILED) throw flat_error("mremap", m_file_name);
+    m_map = static_cast<char*>(map);
+    m_slots = capacity;
+}
+
+
+void
+FlatNodes::set(int64_t id, int32_t lat, int32_t lon) {
+    if (id < 0) {
+        m_negative[id] = std::make_pair(lat, lon);
+        return;
+    }
+    auto slot = static_cast<uint64_t>(id);
+    if (slot >= m_slots) grow_file(slot + 1);
+    auto values = reinterpret_cast<uint32_t*>(m_map + header_size) + 2 * slot;
+    values[0] = encode(lat);
+    values[1] = encode(lon);
+}
+
+
+bool
+FlatNodes::get(int64_t id, int32_t &lat, int32_t &lon) const {
+    if (id < 0) {
+        auto it = m_negative.find(id);
+        if (it == m_negative.end()) return false;
+        lat = it->second.first;
+        lon = it->second.second;
+        return true;
+    }
+    auto slot = static_cast<uint64_t>(id);
+    if (slot >= m_slots) return false;
+    auto values = reinterpret_cast<const uint32_t*>(m_map + header_size) + 2 * slot;
+    if (values[0] == 0 && values[1] == 0) return false;
+    lat = decode(values[0]);
+    lon = decode(values[1]);
+    return true;
+}
+
+
+void
+FlatNodes::complete() {
+    auto header = reinterpret_cast<Header*>(m_map);
+    if (header->input_size == 0) return;
+    msync(m_map, header_size + m_slots * sizeof(uint64_t), MS_SYNC);
+    header->complete = 1;
+    msync(m_map, header_size, MS_SYNC);
+}
+
+
+/*
+ * the counters are only needed during the run: anonymous memory,
+ * the untouched pages use none
+ */
+void
+FlatNodes::grow_uses(uint64_t ids) {
+    auto capacity = std::max<uint64_t>(m_uses_capacity, min_slots * 16);
+    while (capacity < ids) capacity *= 2;
+    void *map;
+    if (m_uses) {
+        map = mremap(m_uses, m_uses_capacity, capacity, MREMAP_MAYMOVE);
+    } else {
+        map = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    }
+    if (map == MAP_FAILED) throw flat_error("node uses", m_file_name);
+    m_uses = static_cast<unsigned char*>(map);
+    m_uses_capacity = capacity;
+}
+
+
+void
+FlatNodes::add_use(int64_t id) {
+    if (id < 0) {
+        ++m_negative_uses[id];
+        return;
+    }
+    auto slot = static_cast<uint64_t>(id);
+    if (slot >= m_uses_capacity) grow_uses(slot + 1);
+    if (m_uses[slot] < 255) ++m_uses[slot];
+}
+
+
+uint16_t
+FlatNodes::uses(int64_t id) const {
+    if (id < 0) {
+        auto it = m_negative_uses.find(id);
+        return it == m_negative_uses.end() ? 0 : it->second;
+    }
+    auto slot = static_cast<uint64_t>(id);
+    return slot < m_uses_capacity ? m_uses[slot] : 0;
+}
+
+}  // namespace osm2pgr
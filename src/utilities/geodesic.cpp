@@ -0,0 +1,145 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+#include "utilities/geodesic.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace osm2pgr {
+
+namespace {
+
+/* WGS84 */
+const double semi_major = 6378137.0;
+const double flattening = 1 / 298.257223563;
+const double semi_minor = semi_major * (1 - flattening);
+const double eccentricity2 = flattening * (2 - flattening);
+const double mean_radius = (2 * semi_major + semi_minor) / 3;
+
+const double pi = 3.14159265358979323846;
+const double e7_radians = pi / 180 / 1e7;
+
+
+/*
+ * meridian (M) and prime vertical (N) radii of curvature at the mid latitude
+ */
+inline
+double
+flat_distance(int32_t lon1, int32_t lat1, int32_t lon2, int32_t lat2) {
+    auto mid = (static_cast<double>(lat1) + static_cast<double>(lat2)) * (e7_radians / 2);
+    auto sin_mid = std::sin(mid);
+    auto cos_mid = std::cos(mid);
+    auto w2 = 1 - eccentricity2 * sin_mid * sin_mid;
+    auto w = std::sqrt(w2);
+    auto N = semi_major / w;
+    auto M = semi_major * (1 - eccentricity2) / (w2 * w);
+
+    auto dx = N * cos_mid * (static_cast<double>(lon2) - static_cast<double>(lon1)) * e7_radians;
+    auto dy = M * (static_cast<double>(lat2) - static_cast<double>(lat1)) * e7_radians;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+
+inline
+bool
+is_flat(int32_t lon1, int32_t lat1, int32_t lon2, int32_t lat2) {
+    return std::llabs(static_cast<int64_t>(lon2) - lon1)
+        + std::llabs(static_cast<int64_t>(lat2) - lat1) <= geodesic_flat_limit;
+}
+
+
+double
+haversine_distance(double lon1, double lat1, double lon2, double lat2) {
+    auto dlat = (lat2 - lat1) * (pi / 180);
+    auto dlon = (lon2 - lon1) * (pi / 180);
+    auto s_lat = std::sin(dlat / 2);
+    auto s_lon = std::sin(dlon / 2);
+    auto h = s_lat * s_lat
+        + std::cos(lat1 * (pi / 180)) * std::cos(lat2 * (pi / 180)) * s_lon * s_lon;
+    return 2 * mean_radius * std::asin(std::sqrt(std::fmin(1.0, h)));
+}
+
+}  // namespace
+
+
+double
+vincenty_distance(double lon1, double lat1, double lon2, double lat2) {
+    auto L = (lon2 - lon1) * (pi / 180);
+    auto U1 = std::atan((1 - flattening) * std::tan(lat1 * (pi / 180)));
+    auto U2 = std::atan((1 - flattening) * std::tan(lat2 * (pi / 180)));
+    auto sin_U1 = std::sin(U1), cos_U1 = std::cos(U1);
+    auto sin_U2 = std::sin(U2), cos_U2 = std::cos(U2);
+
+    auto lambda = L;
+    double sin_sigma, cos_sigma, sigma, cos2_alpha, cos_2sigma_m;
+    int iterations = 0;
+    while (true) {
+        auto sin_lambda = std::sin(lambda);
+        auto cos_lambda = std::cos(lambda);
+        sin_sigma = std::hypot(
+                cos_U2 * sin_lambda,
+                cos_U1 * sin_U2 - sin_U1 * cos_U2 * cos_lambda);
+        if (sin_sigma == 0) return 0;
+
+        cos_sigma = sin_U1 * sin_U2 + cos_U1 * cos_U2 * cos_lambda;
+        sigma = std::atan2(sin_sigma, cos_sigma);
+        auto sin_alpha = cos_U1 * cos_U2 * sin_lambda / sin_sigma;
+        cos2_alpha = 1 - sin_alpha * sin_alpha;
+        /* on the equator */
+        cos_2sigma_m = cos2_alpha == 0 ? 0 : cos_sigma - 2 * sin_U1 * sin_U2 / cos2_alpha;
+
+        auto C = flattening / 16 * cos2_alpha * (4 + flattening * (4 - 3 * cos2_alpha));
+        auto previous = lambda;
+        lambda = L + (1 - C) * flattening * sin_alpha
+            * (sigma + C * sin_sigma * (cos_2sigma_m + C * cos_sigma * (-1 + 2 * cos_2sigma_m * cos_2sigma_m)));
+
+        if (std::fabs(lambda - previous) < 1e-12) break;
+        if (++iterations == 200) return haversine_distance(lon1, lat1, lon2, lat2);
+    }
+
+    auto u2 = cos2_alpha * (semi_major * semi_major - semi_minor * semi_minor) / (semi_minor * semi_minor);
+    auto A = 1 + u2 / 16384 * (4096 + u2 * (-768 + u2 * (320 - 175 * u2)));
+    auto B = u2 / 1024 * (256 + u2 * (-128 + u2 * (74 - 47 * u2)));
+    auto delta_sigma = B * sin_sigma * (cos_2sigma_m + B / 4
+            * (cos_sigma * (-1 + 2 * cos_2sigma_m * cos_2sigma_m)
+                - B / 6 * cos_2sigma_m * (-3 + 4 * sin_sigma * sin_sigma) * (-3 + 4 * cos_2sigma_m * cos_2sigma_m)));
+
+    return semi_minor * A * (sigma - delta_sigma);
+}
+
+
+double
+geodesic_distance(int32_t lon1, int32_t lat1, int32_t lon2, int32_t lat2) {
+    if (is_flat(lon1, lat1, lon2, lat2)) return flat_distance(lon1, lat1, lon2, lat2);
+    return vincenty_distance(lon1 / 1e7, lat1 / 1e7, lon2 / 1e7, lat2 / 1e7);
+}
+
+
+double
+geodesic_length(const int32_t *lon, const int32_t *lat, size_t n) {
+    double length = 0;
+    for (size_t i = 1; i < n; ++i) {
+        length += geodesic_distance(lon[i - 1], lat[i - 1], lon[i], lat[i]);
+    }
+    return length;
+}
+
+}  // namespace osm2pgr
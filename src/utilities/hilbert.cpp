@@ -0,0 +1,53 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+
+#include "utilities/hilbert.h"
+
+namespace osm2pgr {
+
+/*
+ * the quadrant of each level, from the largest one,
+ * rotating the coordinates as the curve does
+ */
+uint64_t
+hilbert_key(int32_t lon, int32_t lat) {
+    auto x = static_cast<uint32_t>(static_cast<int64_t>(lon) + 1800000000);
+    auto y = static_cast<uint32_t>(static_cast<int64_t>(lat) + 900000000) << 1;
+
+    uint64_t key = 0;
+    for (uint32_t level = 1u << 31; level; level >>= 1) {
+        uint32_t rx = (x & level) ? 1 : 0;
+        uint32_t ry = (y & level) ? 1 : 0;
+        key += static_cast<uint64_t>(level) * level * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = ~x;
+                y = ~y;
+            }
+            auto t = x;
+            x = y;
+            y = t;
+        }
+    }
+    return key;
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,33 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+#include "utilities/id_bitmap.h"
+
+namespace osm2pgr {
+
+size_t
+IdBitmap::memory() const {
+    size_t bytes = m_pages.capacity() * sizeof(m_pages[0]);
+    for (const auto &page : m_pages) {
+        if (page) bytes += page_words * sizeof(uint64_t);
+    }
+    return bytes + m_negative.size() * sizeof(int64_t);
+}
+
+}  // namespace osm2pgr
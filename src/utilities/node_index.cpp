@@ -0,0 +1,205 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+#include "utilities/node_index.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osm2pgr {
+
+const size_t NodeIndex::npos = std::numeric_limits<size_t>::max();
+
+
+std::unique_ptr<NodeIndex>
+NodeIndex::create(const std::string &type) {
+    if (type == "sorted") return std::unique_ptr<NodeIndex>(new SortedNodeIndex());
+    if (type == "dense") return std::unique_ptr<NodeIndex>(new DenseNodeIndex());
+    if (type == "sparse") return std::unique_ptr<NodeIndex>(new SparseNodeIndex());
+    throw std::invalid_argument("Unknown node index: " + type + " (sorted, dense or sparse)");
+}
+
+
+/*
+ * sorted
+ */
+
+void
+SortedNodeIndex::add(int64_t id, size_t position) {
+    if (m_sorted && m_positions.empty()
+            && position == m_ids.size()
+            && (m_ids.empty() || m_ids.back() < id)) {
+        m_ids.push_back(id);
+        return;
+    }
+    if (m_positions.empty()) {
+        m_positions.resize(m_ids.size());
+        std::iota(m_positions.begin(), m_positions.end(), size_t(0));
+    }
+    m_sorted = m_sorted && (m_ids.empty() || m_ids.back() < id);
+    m_ids.push_back(id);
+    m_positions.push_back(position);
+}
+
+
+void
+SortedNodeIndex::finish() {
+    if (m_sorted) return;
+    std::vector<size_t> order(m_ids.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return m_ids[a] < m_ids[b];});
+
+    std::vector<int64_t> ids(m_ids.size());
+    std::vector<size_t> positions(m_ids.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        ids[i] = m_ids[order[i]];
+        positions[i] = m_positions[order[i]];
+    }
+    m_ids.swap(ids);
+    m_positions.swap(positions);
+    m_sorted = true;
+}
+
+
+size_t
+SortedNodeIndex::find(int64_t id) const {
+    if (!m_sorted) {
+        /* the first one added, as after the stable sort */
+        auto it = std::find(m_ids.begin(), m_ids.end(), id);
+        return it == m_ids.end() ? npos : m_positions[static_cast<size_t>(it - m_ids.begin())];
+    }
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it == m_ids.end() || *it != id) return npos;
+    auto i = static_cast<size_t>(it - m_ids.begin());
+    return m_positions.empty() ? i : m_positions[i];
+}
+
+
+size_t
+SortedNodeIndex::memory() const {
+    return m_ids.capacity() * sizeof(int64_t) + m_positions.capacity() * sizeof(size_t);
+}
+
+
+/*
+ * dense
+ */
+
+DenseNodeIndex::~DenseNodeIndex() {
+    if (m_slots) munmap(m_slots, m_capacity * sizeof(uint32_t));
+}
+
+
+/*
+ * the untouched pages of the mapping use no memory
+ */
+void
+DenseNodeIndex::reserve(uint64_t slots) {
+    const uint64_t min_slots = uint64_t(1) << 24;
+    auto capacity = std::max(min_slots, m_capacity);
+    while (capacity < slots) capacity *= 2;
+
+    void *map;
+    if (m_slots) {
+        map = mremap(m_slots, m_capacity * sizeof(uint32_t), capacity * sizeof(uint32_t), MREMAP_MAYMOVE);
+    } else {
+        map = mmap(NULL, capacity * sizeof(uint32_t), PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    }
+    if (map == MAP_FAILED) {
+        throw std::runtime_error(std::string("Dense node index: ") + strerror(errno));
+    }
+    m_slots = static_cast<uint32_t*>(map);
+    m_capacity = capacity;
+}
+
+
+void
+DenseNodeIndex::add(int64_t id, size_t position) {
+    if (id < 0) {
+        if (m_negative.insert(std::make_pair(id, position)).second) ++m_size;
+        return;
+    }
+    if (position >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Dense node index: more than 2^32 - 1 nodes");
+    }
+    auto slot = static_cast<uint64_t>(id);
+    if (slot >= m_capacity) reserve(slot + 1);
+    if (m_slots[slot] == 0) ++m_size;
+    m_slots[slot] = static_cast<uint32_t>(position + 1);
+}
+
+
+size_t
+DenseNodeIndex::find(int64_t id) const {
+    if (id < 0) {
+        auto it = m_negative.find(id);
+        return it == m_negative.end() ? npos : it->second;
+    }
+    auto slot = static_cast<uint64_t>(id);
+    if (slot >= m_capacity || m_slots[slot] == 0) return npos;
+    return m_slots[slot] - 1;
+}
+
+
+/*
+ * resident pages, as counted by the kernel
+ */
+size_t
+DenseNodeIndex::memory() const {
+    if (!m_slots) return 0;
+    auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto bytes = m_capacity * sizeof(uint32_t);
+    std::vector<unsigned char> resident((bytes + page - 1) / page);
+    if (mincore(m_slots, bytes, resident.data()) != 0) return bytes;
+    size_t pages = 0;
+    for (auto r : resident) pages += r & 1;
+    return pages * page;
+}
+
+
+/*
+ * sparse
+ */
+
+size_t
+SparseNodeIndex::find(int64_t id) const {
+    auto it = m_positions.find(id);
+    return it == m_positions.end() ? npos : it->second;
+}
+
+
+size_t
+SparseNodeIndex::memory() const {
+    /* a node of the list per element plus the bucket array */
+    return m_positions.size() * (sizeof(std::pair<const int64_t, size_t>) + sizeof(void*))
+        + m_positions.bucket_count() * sizeof(void*);
+}
+
+}  // namespace osm2pgr
@@ -46,7 +46,7 @@ void get_option_description(po::options_description &od_desc) {
 
     general_od_desc.add_options()
         // general
-        ("file,f", po::value<std::string>()->required(), "REQUIRED: Name of the osm file.")
+        ("file,f", po::value<std::string>()->required(), "REQUIRED: Name of the osm file (.osm or .osm.pbf).")
         ("conf,c", po::value<std::string>()->default_value("/usr/share/osm2pgrouting/mapconfig.xml"), "Name of the configuration xml file.")
         ("schema", po::value<std::string>()->default_value(""), "Database schema to put tables.\n  blank:\t defaults to default schema dictated by PostgreSQL search_path.")
         ("prefix", po::value<std::string>()->default_value(""), "Prefix added at the beginning of the table names.")
@@ -58,6 +58,21 @@ void get_option_description(po::options_description &od_desc) {
         ("attributes", "Include attributes information.")
         ("tags", "Include tag information.")
         ("chunk", po::value<std::size_t>()->default_value(20000), "Exporting chunk size.")
+        ("writer-threads", po::value<std::size_t>()->default_value(1), "With --addnodes: threads exporting the chunks of the osm tables, each on its own connection, while the file is parsed.\n  0:\t the parser exports them.")
+        ("parse-threads", po::value<std::size_t>()->default_value(1), "Threads parsing an uncompressed .osm file.\n  0:\t one per core.")
+        ("node-index", po::value<std::string>()->default_value("sorted"), "Index of the nodes by id.\n  sorted:\t sorted array of ids.\n  dense:\t array indexed by id, for very large files.\n  sparse:\t hash table, for small files.")
+        ("flat-nodes", po::value<std::string>(), "File keeping the node coordinates, indexed by node id, instead of the memory.\n  Reused by the next run on the same input.")
+        ("two-pass", "Keep in memory only the nodes of the routable ways, found on a first pass over the file.\n  With --addnodes the tagged nodes are kept too.")
+        ("fast-xml", "Parse uncompressed .osm files with the built-in tokenizer, expat handles what it does not support.")
+        ("text-copy", "Send the data with text COPY instead of binary COPY, for debugging.")
+        ("bulk", "Fresh imports: COPY all the ways into the ways table in a single COPY.\n  Ignored when --threads is more than 1 or the ways table has rows.")
+        ("threads,t", po::value<std::size_t>()->default_value(1), "Connections copying the chunks of ways at the same time.\n  The rows are written in order, the gids do not depend on it.")
+        ("split-threads", po::value<std::size_t>()->default_value(1), "Threads splitting the ways and writing their rows.\n  The rows are the same as with one thread.\n  0:\t one per core.")
+        ("hilbert", "Sort the split ways and the new vertices along a Hilbert curve: neighbouring rows share the pages of the tables.\n  The split ways are kept in memory until they are written.")
+        ("contract", "Merge the split ways meeting at vertices of degree 2, with the same tag, oneway and maxspeeds, into one row.\n  The ways_pieces table maps the rows to the OSM ways.")
+        ("components", "Write the connected component of each split way and vertex: the smallest vertex id of the component, as pgr_connectedComponents.\n  The split ways are kept in memory until they are written.")
+        ("prune", po::value<std::size_t>()->default_value(0), "Don't write the components with fewer vertices (implies --components).\n  Components reaching vertices of the table are kept.")
+        ("csr", po::value<std::string>(), "Also write the split ways to this file as a compressed sparse row graph (offsets, targets, costs, coordinates, gids) that routing engines can map in memory.")
         ("clean", "Drop previously created tables.")
         ("no-index", "Do not create indexes (Use when indexes are already created)");
 #if 0
@@ -76,7 +91,6 @@ void get_option_description(po::options_description &od_desc) {
         ("password,W", po::value<std::string>()->default_value(""), "Password for database access.");
 
     not_used_od_desc.add_options()
-        ("threads,t", po::value<bool>()->default_value(false), "threads.")
         ("multimodal,m", po::value<bool>()->default_value(false), "multimodal.")
         ("multilevel,l", po::value<bool>()->default_value(false), "multilevel.");
 
@@ -101,9 +115,24 @@ process_command_line(po::variables_map &vm) {
     std::cout << "schema= " << vm["schema"].as<std::string>() << "\n";
     std::cout << "prefix = " << vm["prefix"].as<std::string>() << "\n";
     std::cout << "suffix = " << vm["suffix"].as<std::string>() << "\n";
+    std::cout << "writer threads = " << vm["writer-threads"].as<std::size_t>() << "\n";
+    std::cout << "parse threads = " << vm["parse-threads"].as<std::size_t>() << "\n";
+    std::cout << "node index = " << vm["node-index"].as<std::string>() << "\n";
+    if (vm.count("flat-nodes")) std::cout << "flat nodes = " << vm["flat-nodes"].as<std::string>() << "\n";
+    std::cout << (vm.count("two-pass")? "K" : "Don't k") << "eep only the nodes of routable ways\n";
+    std::cout << (vm.count("fast-xml")? "U" : "Don't u") << "se the XML tokenizer\n";
 #if 0
     std::cout << (vm.count("postgis")? "I" : "Don't I") << "nstall postgis if not found\n";
 #endif
+    std::cout << "COPY format = " << (vm.count("text-copy")? "text" : "binary") << "\n";
+    std::cout << (vm.count("bulk")? "B" : "Don't b") << "ulk load the ways\n";
+    std::cout << (vm.count("hilbert")? "S" : "Don't s") << "ort the ways along a Hilbert curve\n";
+    std::cout << (vm.count("contract")? "M" : "Don't m") << "erge the split ways through vertices of degree 2\n";
+    std::cout << (vm.count("components")? "W" : "Don't w") << "rite the connected components\n";
+    if (vm["prune"].as<std::size_t>() > 0) std::cout << "prune components below = " << vm["prune"].as<std::size_t>() << " vertices\n";
+    if (vm.count("csr")) std::cout << "csr graph = " << vm["csr"].as<std::string>() << "\n";
+    std::cout << "split threads = " << vm["split-threads"].as<std::size_t>() << "\n";
+    std::cout << "ways connections = " << vm["threads"].as<std::size_t>() << "\n";
     std::cout << (vm.count("clean")? "D" : "Don't d") << "rop tables\n";
     std::cout << (vm.count("no-index")? "D" : "Don't c") << "reate indexes\n";
     std::cout << (vm.count("addnodes")? "A" : "Don't a") << "dd OSM nodes\n";
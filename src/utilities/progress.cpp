@@ -0,0 +1,110 @@
+/*PGR-GNU*****************************************************************
+
+ Copyright (c) 2026 pgRouting developers
+ Mail: project@pgrouting.org
+
+ ------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+********************************************************************PGR-GNU*/
+
+
+#include "utilities/progress.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace osm2pgr {
+
+ProgressReporter::ProgressReporter(
+        const ProgressCounters &counters,
+        uint64_t total_bytes,
+        std::chrono::milliseconds interval) :
+    m_counters(counters),
+    m_total_bytes(total_bytes),
+    m_interval(interval),
+    m_start(std::chrono::steady_clock::now()),
+    m_stop(false),
+    m_thread(&ProgressReporter::run, this) {
+}
+
+
+ProgressReporter::~ProgressReporter() {
+    stop();
+}
+
+
+void
+ProgressReporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) return;
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    report();
+    std::cout << std::endl;
+}
+
+
+void
+ProgressReporter::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_cv.wait_for(lock, m_interval, [this] {return m_stop;})) {
+        report();
+    }
+}
+
+
+void
+ProgressReporter::report() const {
+    auto bytes = m_counters.bytes.load(std::memory_order_relaxed);
+    auto elements = m_counters.elements.load(std::memory_order_relaxed);
+    double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - m_start).count();
+    double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    double mb_per_sec = secs > 0 ? megabytes / secs : 0;
+    double elements_per_sec = secs > 0 ? static_cast<double>(elements) / secs : 0;
+
+    std::ostringstream line;
+    line << "\r" << std::fixed << std::setprecision(1);
+
+    if (m_total_bytes) {
+        double fraction = std::min(1.0, static_cast<double>(bytes) / static_cast<double>(m_total_bytes));
+        const int length = 50;
+        int filler = static_cast<int>(fraction * length);
+        line << "[" << std::string(filler, '*') << "|" << std::string(length - filler, ' ') << "]"
+            << " (" << static_cast<int>(100 * fraction) << "%) ";
+    }
+
+    line << megabytes << " MB, "
+        << mb_per_sec << " MB/s, "
+        << elements << " elements, "
+        << static_cast<uint64_t>(elements_per_sec) << " elements/s";
+
+    if (m_total_bytes && bytes && bytes < m_total_bytes) {
+        auto left = static_cast<uint64_t>(secs * static_cast<double>(m_total_bytes - bytes) / static_cast<double>(bytes));
+        line << ", ETA "
+            << left / 3600 << ":"
+            << std::setfill('0') << std::setw(2) << (left / 60) % 60 << ":"
+            << std::setw(2) << left % 60;
+    }
+    /* clears what is left of a longer previous line */
+    line << "   ";
+    std::cout << line.str() << std::flush;
+}
+
+}  // namespace osm2pgr
@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+
+/*
+ * Split edges per second written to the COPY buffer of the ways table
+ *
+ * before: the rows built as vectors of strings joined by tab_separated
+ * text, binary: WayRows writing into a CopyBuffer of each format
+ *
+ * The heap allocations are counted to check that, once the buffers
+ * have grown, the rows are written without allocating.
+ *
+ * usage: copy_rows_benchmark [ways] [nodes per way]
+ */
+
+#include <boost/lexical_cast.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "configuration/configuration.h"
+#include "database/way_rows.h"
+#include "osm_elements/Node.h"
+#include "osm_elements/Way.h"
+#include "utilities/copy_buffer.h"
+#include "utilities/utilities.h"
+
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+
+namespace {
+
+const size_t buffer_size = 1 << 20;
+
+template <typename T>
+std::string
+TO_STR(const T &x) {
+    return  boost::lexical_cast<std::string>(x);
+}
+
+/*
+ * the rows of the ways table as they were built before WayRows
+ */
+size_t
+strings_rows(
+        const std::vector<osm2pgr::Way> &ways,
+        const osm2pgr::Configuration &config,
+        std::string &sink) {
+    size_t edges = 0;
+    for (auto it = ways.begin(); it != ways.end(); ++it) {
+        auto way = *it;
+        std::vector<std::string> common_values;
+        common_values.push_back(TO_STR(config.tag_value(way.tag_config()).id()));
+        common_values.push_back(TO_STR(way.osm_id()));
+        common_values.push_back(way.maxspeed_forward_str() == "-1" ? TO_STR(config.maxspeed_forward(way.tag_config())) : way.maxspeed_forward_str());
+        common_values.push_back(way.maxspeed_backward_str() == "-1" ? TO_STR(config.maxspeed_backward(way.tag_config())) : way.maxspeed_backward_str());
+        common_values.push_back(way.oneWayType_str());
+        common_values.push_back(way.oneWay());
+        common_values.push_back(TO_STR(config.priority(way.tag_config())));
+
+        auto splits = way.split_me();
+        edges += splits.size();
+        for (size_t j = 0; j < splits.size(); ++j) {
+            auto length = way.length_str(splits[j]);
+
+            auto values = common_values;
+            values.push_back(length);
+            values.push_back(splits[j].front()->lon());
+            values.push_back(splits[j].front()->lat());
+            values.push_back(splits[j].back()->lon());
+            values.push_back(splits[j].back()->lat());
+            values.push_back(TO_STR(splits[j].front()->osm_id()));
+            values.push_back(TO_STR(splits[j].back()->osm_id()));
+            values.push_back(way.geometry_str(splits[j]));
+            values.push_back(way.is_reversed() ? std::string("-") + length : length);
+            values.push_back(way.is_oneway() ? std::string("-") + length : length);
+            values.push_back(way.name());
+            sink += tab_separated(values);
+            if (sink.size() >= buffer_size) sink.clear();
+        }
+    }
+    return edges;
+}
+
+size_t
+copy_rows(
+        const std::vector<osm2pgr::Way> &ways,
+        osm2pgr::WayRows &way_rows,
+        osm2pgr::CopyBuffer &rows) {
+    size_t edges = 0;
+    for (const auto &way : ways) {
+        edges += way_rows.add(way, way.nodeRefs(), rows);
+        if (rows.size() >= buffer_size) rows.clear();
+    }
+    return edges;
+}
+
+void
+report(const char *name, std::chrono::steady_clock::time_point begin, size_t edges, size_t allocated) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << name << ":\t"
+        << static_cast<double>(edges) / elapsed.count() << " edges/s\t"
+        << static_cast<double>(allocated) / static_cast<double>(edges) << " allocations/edge\n";
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    size_t n_ways = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 200000;
+    size_t way_nodes = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 8;
+    if (way_nodes < 2) way_nodes = 2;
+
+    const char *key_atts[] = {"name", "highway", "id", "1", NULL};
+    const char *value_atts[] = {"name", "residential", "id", "110", "priority", "1", "maxspeed", "50", NULL};
+    osm2pgr::Tag_key key(key_atts);
+    key.add_tag_value(osm2pgr::Tag_value(value_atts));
+    osm2pgr::Configuration config;
+    config.add_tag_key(key);
+
+    /* a row of nodes per way, every third node shared with a crossing way */
+    std::vector<osm2pgr::Node> nodes;
+    nodes.reserve(n_ways * way_nodes);
+    for (size_t i = 0; i < n_ways * way_nodes; ++i) {
+        nodes.push_back(osm2pgr::Node(static_cast<int64_t>(i + 1),
+                    450000000 + static_cast<int32_t>(i / way_nodes) * 1000,
+                    80000000 + static_cast<int32_t>(i % way_nodes) * 1379));
+        nodes.back().numsOfUse(i % 3 == 0 ? 2 : 1);
+    }
+
+    std::vector<osm2pgr::Way> ways;
+    ways.reserve(n_ways);
+    for (size_t i = 0; i < n_ways; ++i) {
+        auto id = std::to_string(i + 1);
+        const char *atts[] = {"id", id.c_str(), NULL};
+        ways.push_back(osm2pgr::Way(atts));
+        auto &way = ways.back();
+        way.add_tag(osm2pgr::Tag("highway", "residential"));
+        way.add_tag(osm2pgr::Tag("name", "Street " + id));
+        way.tag_config(osm2pgr::Tag("highway", "residential"));
+        for (size_t j = 0; j < way_nodes; ++j) way.add_node(&nodes[i * way_nodes + j]);
+    }
+
+    std::string sink;
+    sink.reserve(buffer_size + buffer_size / 4);
+    auto allocated = allocations;
+    auto begin = std::chrono::steady_clock::now();
+    auto edges = strings_rows(ways, config, sink);
+    report("before", begin, edges, allocations - allocated);
+
+    /* the vertices are numbered by a first pass: the measured passes look them up */
+    osm2pgr::VertexIds vertex_ids;
+    {
+        osm2pgr::EdgeKeys edge_keys;
+        osm2pgr::WayRows way_rows(config, vertex_ids, edge_keys);
+        osm2pgr::CopyBuffer rows(false);
+        copy_rows(ways, way_rows, rows);
+    }
+
+    for (const auto binary : {false, true}) {
+        osm2pgr::EdgeKeys edge_keys;
+        osm2pgr::WayRows way_rows(config, vertex_ids, edge_keys);
+        osm2pgr::CopyBuffer rows(binary);
+        rows.reserve(buffer_size + buffer_size / 4);
+        allocated = allocations;
+        begin = std::chrono::steady_clock::now();
+        edges = copy_rows(ways, way_rows, rows);
+        report(binary ? "binary" : "text", begin, edges, allocations - allocated);
+    }
+    return 0;
+}
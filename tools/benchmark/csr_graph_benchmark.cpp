@@ -0,0 +1,154 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*
+ * Start up of a routing engine on the --csr file
+ *
+ * Maps a graph file written by --csr and times the mapping, then
+ * Dijkstra queries from random vertices to their whole component,
+ * straight on the mapped arrays (the costs of the arcs, negative
+ * costs can not be used).
+ *
+ * Without a file, a grid of side x side intersections is written first
+ * (to csr_graph_benchmark.csr, removed at the end), one way streets on
+ * every third row.
+ *
+ * usage: csr_graph_benchmark [file.csr | -] [queries] [grid side]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utilities/csr_graph.h"
+
+
+namespace {
+
+double
+seconds_since(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+std::vector<osm2pgr::CsrGraph::Edge>
+grid(size_t side) {
+    const int32_t block = 10000;
+    std::vector<osm2pgr::CsrGraph::Edge> edges;
+    int64_t gid = 0;
+    auto add = [&](size_t a, size_t b, bool oneway) {
+        auto lon = [side, block](size_t v) {return 80000000 + static_cast<int32_t>(v % side) * block;};
+        auto lat = [side, block](size_t v) {return 450000000 + static_cast<int32_t>(v / side) * block;};
+        double cost = 0.0001;
+        edges.push_back(osm2pgr::CsrGraph::Edge{++gid,
+                static_cast<int64_t>(a + 1), static_cast<int64_t>(b + 1), cost, oneway ? -cost : cost,
+                lon(a), lat(a), lon(b), lat(b)});
+    };
+    for (size_t i = 0; i < side; ++i) {
+        for (size_t j = 0; j < side; ++j) {
+            auto v = i * side + j;
+            if (j + 1 < side) add(v, v + 1, i % 3 == 0);
+            if (i + 1 < side) add(v, v + side, false);
+        }
+    }
+    return edges;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    std::string file_name = argc > 1 ? argv[1] : "-";
+    size_t n_queries = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 10;
+    size_t side = argc > 3 ? std::strtoull(argv[3], NULL, 10) : 1000;
+    if (!n_queries) n_queries = 1;
+    if (side < 2) side = 2;
+
+    try {
+        bool synthetic = file_name == "-";
+        if (synthetic) {
+            file_name = "csr_graph_benchmark.csr";
+            auto edges = grid(side);
+            auto begin = std::chrono::steady_clock::now();
+            auto header = osm2pgr::CsrGraph::write(file_name, edges);
+            std::cout << "written:\t" << header.vertices << " vertices, " << header.edges << " edges, "
+                << header.file_size << " bytes in " << seconds_since(begin) << " s\n";
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        osm2pgr::CsrFile graph(file_name);
+        std::cout << "mapped:\t\t" << seconds_since(begin) * 1000 << " ms\n";
+
+        const auto &header = graph.header();
+        const auto *offsets = graph.offsets();
+        const auto *targets = graph.targets();
+        const auto *costs = graph.costs();
+        if (header.vertices == 0) {
+            std::cout << "empty graph\n";
+            return 0;
+        }
+
+        std::mt19937_64 random(42);
+        std::uniform_int_distribution<uint64_t> vertex(0, header.vertices - 1);
+        std::vector<double> distance(header.vertices);
+        using Entry = std::pair<double, uint32_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        size_t settled = 0;
+
+        begin = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < n_queries; ++q) {
+            std::fill(distance.begin(), distance.end(), std::numeric_limits<double>::infinity());
+            auto source = static_cast<uint32_t>(vertex(random));
+            distance[source] = 0;
+            queue.emplace(0, source);
+            while (!queue.empty()) {
+                auto top = queue.top();
+                queue.pop();
+                if (top.first > distance[top.second]) continue;
+                ++settled;
+                for (auto arc = offsets[top.second]; arc < offsets[top.second + 1]; ++arc) {
+                    if (costs[arc] < 0) continue;
+                    auto d = top.first + costs[arc];
+                    if (d < distance[targets[arc]]) {
+                        distance[targets[arc]] = d;
+                        queue.emplace(d, targets[arc]);
+                    }
+                }
+            }
+        }
+        auto elapsed = seconds_since(begin);
+        std::cout << "dijkstra:\t" << elapsed / static_cast<double>(n_queries) * 1000 << " ms per query, "
+            << static_cast<double>(settled) / static_cast<double>(n_queries) << " vertices settled\n";
+
+        if (synthetic) std::remove(file_name.c_str());
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*
+ * Accuracy and time per segment of the geodesic lengths
+ *
+ * Random segments, of growing spans around the flat limit, measured
+ * by geodesic_distance and by Vincenty's formula; and the reference
+ * line of Vincenty's inverse example (Flinders Peak to Buninyong,
+ * 54972.271 m).
+ *
+ * Exits with 1 when a length is off by more than a millimeter.
+ *
+ * usage: geodesic_benchmark [segments]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "utilities/geodesic.h"
+
+
+namespace {
+
+double
+nanoseconds_since(std::chrono::steady_clock::time_point begin, size_t operations) {
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / static_cast<double>(operations);
+}
+
+double
+dms(double degrees, double minutes, double seconds) {
+    return degrees + minutes / 60 + seconds / 3600;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    size_t segments = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 1000000;
+    const double tolerance = 0.001;
+    bool ok = true;
+
+    auto reference = osm2pgr::vincenty_distance(
+            dms(144, 25, 29.52440), -dms(37, 57, 3.72030),
+            dms(143, 55, 35.38390), -dms(37, 39, 10.15610));
+    std::cout << "Flinders Peak - Buninyong:\t" << std::setprecision(9) << reference << std::setprecision(6) << " m (54972.271)\n";
+    ok = std::fabs(reference - 54972.271) < tolerance && ok;
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<int32_t> any_lon(-1800000000, 1800000000);
+    std::uniform_int_distribution<int32_t> any_lat(-850000000, 850000000);
+    for (int32_t span : {1000, 10000, 100000, 500000, 1000000, 10000000}) {
+        std::uniform_int_distribution<int32_t> step(-span / 2, span / 2);
+        std::vector<int32_t> lon(2 * segments), lat(2 * segments);
+        for (size_t i = 0; i < lon.size(); i += 2) {
+            lon[i] = any_lon(random);
+            lat[i] = any_lat(random);
+            lon[i + 1] = lon[i] + step(random);
+            lat[i + 1] = lat[i] + step(random);
+        }
+
+        std::vector<double> lengths(segments);
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < segments; ++i) {
+            lengths[i] = osm2pgr::geodesic_distance(lon[2 * i], lat[2 * i], lon[2 * i + 1], lat[2 * i + 1]);
+        }
+        auto ns = nanoseconds_since(begin, segments);
+
+        double max_error = 0;
+        for (size_t i = 0; i < segments; ++i) {
+            auto exact = osm2pgr::vincenty_distance(
+                    lon[2 * i] / 1e7, lat[2 * i] / 1e7, lon[2 * i + 1] / 1e7, lat[2 * i + 1] / 1e7);
+            max_error = std::fmax(max_error, std::fabs(lengths[i] - exact));
+        }
+        std::cout << "span " << span / 1e7 << " degrees:\t" << ns << " ns/segment\t"
+            << "max error " << max_error << " m\n";
+        ok = max_error < tolerance && ok;
+    }
+
+    return ok ? 0 : 1;
+}
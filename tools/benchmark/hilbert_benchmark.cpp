@@ -0,0 +1,231 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*
+ * Heap pages read by bbox routing queries, rows in way order or in
+ * Hilbert order (--hilbert)
+ *
+ * A grid of streets: each row and column of the grid is cut in ways of
+ * a few blocks, the way ids are shuffled as OSM ids follow the editing
+ * history, not the map. The split ways are the blocks.
+ *
+ * way order: the edges by way id, the vertices numbered as the
+ *            edges reach them, as without --hilbert
+ * hilbert:   the edges and the vertices by hilbert_key
+ *
+ * A query is a pair of random intersections a few kilometers apart
+ * and the edges of their bounding box, plus a margin, as in
+ *   pgr_dijkstra('SELECT ... FROM ways WHERE the_geom && ST_Expand(bbox, margin)', ...)
+ * The pages it reads are the distinct heap pages of those edges (and
+ * of the vertices of the box): the buffer hits of the index scan,
+ * without the pages of the index.
+ *
+ * usage: hilbert_benchmark [grid side] [queries] [edges per page]
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "utilities/hilbert.h"
+
+
+namespace {
+
+//! about 100 m between intersections
+const int32_t block = 10000;
+
+struct Point {
+    int32_t lon;
+    int32_t lat;
+};
+
+struct Edge {
+    int64_t way;
+    size_t position;
+    size_t source;
+    size_t target;
+};
+
+struct Box {
+    int32_t min_lon;
+    int32_t min_lat;
+    int32_t max_lon;
+    int32_t max_lat;
+
+    bool has(const Point &p) const {
+        return min_lon <= p.lon && p.lon <= max_lon && min_lat <= p.lat && p.lat <= max_lat;
+    }
+};
+
+uint64_t
+key(const Point &p) {
+    return osm2pgr::hilbert_key(p.lon, p.lat);
+}
+
+uint64_t
+key(const Point &a, const Point &b) {
+    return osm2pgr::hilbert_key(
+            static_cast<int32_t>((static_cast<int64_t>(a.lon) + b.lon) / 2),
+            static_cast<int32_t>((static_cast<int64_t>(a.lat) + b.lat) / 2));
+}
+
+/*
+ * pages read by the queries: the rows in the order of @b rows,
+ * @b per_page rows on a page
+ */
+struct Result {
+    double pages;
+    double rows;
+};
+
+template <typename Inside>
+Result
+pages_read(
+        const std::vector<size_t> &rows,
+        size_t per_page,
+        const std::vector<Box> &queries,
+        Inside inside) {
+    std::vector<size_t> page(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) page[rows[i]] = i / per_page;
+
+    Result result = {0, 0};
+    std::unordered_set<size_t> pages;
+    for (const auto &box : queries) {
+        pages.clear();
+        for (size_t row = 0; row < rows.size(); ++row) {
+            if (!inside(row, box)) continue;
+            pages.insert(page[row]);
+            ++result.rows;
+        }
+        result.pages += static_cast<double>(pages.size());
+    }
+    result.pages /= static_cast<double>(queries.size());
+    result.rows /= static_cast<double>(queries.size());
+    return result;
+}
+
+void
+report(const char *name, const Result &edges, const Result &vertices) {
+    std::cout << name << ":\t"
+        << edges.pages << " edge pages\t"
+        << vertices.pages << " vertex pages\t("
+        << edges.rows << " edges, " << vertices.rows << " vertices per query)\n";
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    size_t side = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 300;
+    size_t n_queries = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 200;
+    size_t edges_per_page = argc > 3 ? std::strtoull(argv[3], NULL, 10) : 30;
+    /* id, osm_id, lon, lat, the_geom */
+    size_t vertices_per_page = 3 * edges_per_page;
+    if (side < 10) side = 10;
+    if (!n_queries) n_queries = 1;
+    if (!edges_per_page) edges_per_page = 1;
+
+    std::mt19937_64 random(42);
+
+    std::vector<Point> points(side * side);
+    for (size_t i = 0; i < side; ++i) {
+        for (size_t j = 0; j < side; ++j) {
+            points[i * side + j] = Point{
+                80000000 + static_cast<int32_t>(j) * block,
+                450000000 + static_cast<int32_t>(i) * block};
+        }
+    }
+
+    /* the streets: rows and columns cut in ways of 3 to 20 blocks */
+    std::vector<Edge> edges;
+    int64_t n_ways = 0;
+    std::uniform_int_distribution<size_t> way_blocks(3, 20);
+    for (size_t line = 0; line < 2 * side; ++line) {
+        size_t along = 0;
+        while (along + 1 < side) {
+            auto blocks = std::min(way_blocks(random), side - 1 - along);
+            for (size_t k = 0; k < blocks; ++k, ++along) {
+                auto a = line < side ? line * side + along : along * side + (line - side);
+                auto b = line < side ? a + 1 : a + side;
+                edges.push_back(Edge{n_ways, k, a, b});
+            }
+            ++n_ways;
+        }
+    }
+    std::vector<int64_t> way_ids(static_cast<size_t>(n_ways));
+    for (size_t i = 0; i < way_ids.size(); ++i) way_ids[i] = static_cast<int64_t>(i);
+    std::shuffle(way_ids.begin(), way_ids.end(), random);
+    for (auto &edge : edges) edge.way = way_ids[static_cast<size_t>(edge.way)];
+
+    /* pairs 1 to 5 km apart, the box of the pair and 500 m around */
+    std::vector<Box> queries;
+    std::uniform_int_distribution<size_t> node(0, side - 1);
+    std::uniform_int_distribution<int> distance(10, 50);
+    const int32_t margin = 5 * block;
+    while (queries.size() < n_queries) {
+        auto i = node(random);
+        auto j = node(random);
+        auto di = static_cast<size_t>(distance(random));
+        auto dj = static_cast<size_t>(distance(random));
+        if (i + di >= side || j + dj >= side) continue;
+        const auto &a = points[i * side + j];
+        const auto &b = points[(i + di) * side + j + dj];
+        queries.push_back(Box{a.lon - margin, a.lat - margin, b.lon + margin, b.lat + margin});
+    }
+
+    auto edge_inside = [&](size_t e, const Box &box) {
+        return box.has(points[edges[e].source]) || box.has(points[edges[e].target]);
+    };
+    auto vertex_inside = [&](size_t v, const Box &box) {
+        return box.has(points[v]);
+    };
+
+    /* way order, the vertices numbered as the edges reach them */
+    std::vector<size_t> edge_rows(edges.size());
+    for (size_t i = 0; i < edge_rows.size(); ++i) edge_rows[i] = i;
+    std::sort(edge_rows.begin(), edge_rows.end(), [&](size_t a, size_t b) {
+            return edges[a].way != edges[b].way ? edges[a].way < edges[b].way : edges[a].position < edges[b].position;});
+    std::vector<size_t> vertex_rows;
+    std::vector<bool> numbered(points.size(), false);
+    for (auto e : edge_rows) {
+        for (auto v : {edges[e].source, edges[e].target}) {
+            if (numbered[v]) continue;
+            numbered[v] = true;
+            vertex_rows.push_back(v);
+        }
+    }
+    report("way order",
+            pages_read(edge_rows, edges_per_page, queries, edge_inside),
+            pages_read(vertex_rows, vertices_per_page, queries, vertex_inside));
+
+    std::sort(edge_rows.begin(), edge_rows.end(), [&](size_t a, size_t b) {
+            return key(points[edges[a].source], points[edges[a].target])
+                < key(points[edges[b].source], points[edges[b].target]);});
+    std::sort(vertex_rows.begin(), vertex_rows.end(), [&](size_t a, size_t b) {
+            return key(points[a]) < key(points[b]);});
+    report("hilbert",
+            pages_read(edge_rows, edges_per_page, queries, edge_inside),
+            pages_read(vertex_rows, vertices_per_page, queries, vertex_inside));
+    return 0;
+}
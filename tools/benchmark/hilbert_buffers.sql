@@ -0,0 +1,70 @@
+--
+-- Buffers read by bbox routing queries on an imported network
+--
+-- Import the same file twice, with and without --hilbert (for example
+-- with --prefix), and compare:
+--
+--   psql -d routing -f tools/benchmark/hilbert_buffers.sql \
+--        -c "SELECT * FROM pg_temp.bbox_buffers('ways', 'ways_vertices_pgr')" \
+--        -c "SELECT * FROM pg_temp.bbox_buffers('h_ways', 'h_ways_vertices_pgr')"
+--
+-- Each query is a vertex and another vertex at most `distance` degrees
+-- away, the edges of their box expanded by `margin`, as given
+-- to pgr_dijkstra. The shared blocks hit and read are summed over the
+-- EXPLAIN (ANALYZE, BUFFERS) of the edges query and of the pgr_dijkstra
+-- call.
+--
+
+CREATE FUNCTION pg_temp.bbox_buffers(
+        ways regclass,
+        vertices regclass,
+        queries integer DEFAULT 100,
+        distance double precision DEFAULT 0.03,
+        margin double precision DEFAULT 0.005)
+RETURNS TABLE (query text, blocks_hit numeric, blocks_read numeric, edges numeric) AS
+$body$
+DECLARE
+    pair record;
+    box text;
+    edges_sql text;
+    plan json;
+    edges_hit bigint := 0;
+    edges_read bigint := 0;
+    edges_rows bigint := 0;
+    route_hit bigint := 0;
+    route_read bigint := 0;
+BEGIN
+    /* picked by hashes of the osm ids: the same pairs whatever the order of the rows */
+    FOR pair IN EXECUTE format(
+            'SELECT a.id AS source, a.lon AS lon1, a.lat AS lat1, b.id AS target, b.lon AS lon2, b.lat AS lat2'
+            ' FROM (SELECT * FROM %1$s ORDER BY md5(osm_id::text) LIMIT $1) AS a'
+            ' CROSS JOIN LATERAL (SELECT * FROM %1$s AS v'
+            '     WHERE v.the_geom && ST_Expand(a.the_geom, $2) AND v.id <> a.id'
+            '     ORDER BY md5((a.osm_id + v.osm_id)::text) LIMIT 1) AS b',
+            vertices) USING queries, distance LOOP
+        box := format('ST_Expand(ST_MakeEnvelope(%s, %s, %s, %s, 4326), %s)',
+                least(pair.lon1, pair.lon2), least(pair.lat1, pair.lat2),
+                greatest(pair.lon1, pair.lon2), greatest(pair.lat1, pair.lat2), margin);
+        edges_sql := format(
+                'SELECT gid AS id, source, target, cost, reverse_cost FROM %s WHERE the_geom && %s',
+                ways, box);
+
+        EXECUTE 'EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) ' || edges_sql INTO plan;
+        edges_hit := edges_hit + (plan->0->'Plan'->>'Shared Hit Blocks')::bigint;
+        edges_read := edges_read + (plan->0->'Plan'->>'Shared Read Blocks')::bigint;
+        edges_rows := edges_rows + (plan->0->'Plan'->>'Actual Rows')::bigint;
+
+        EXECUTE format('EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) SELECT * FROM pgr_dijkstra(%L, %s, %s)',
+                edges_sql, pair.source, pair.target) INTO plan;
+        route_hit := route_hit + (plan->0->'Plan'->>'Shared Hit Blocks')::bigint;
+        route_read := route_read + (plan->0->'Plan'->>'Shared Read Blocks')::bigint;
+    END LOOP;
+
+    query := 'edges'; blocks_hit := round(edges_hit::numeric / queries, 1);
+    blocks_read := round(edges_read::numeric / queries, 1); edges := round(edges_rows::numeric / queries, 1);
+    RETURN NEXT;
+    query := 'pgr_dijkstra'; blocks_hit := round(route_hit::numeric / queries, 1);
+    blocks_read := round(route_read::numeric / queries, 1);
+    RETURN NEXT;
+END
+$body$ LANGUAGE plpgsql;
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+/*
+ * Time per insertion and per lookup of the node indexes
+ *
+ * The ids grow with random gaps, as on an extract, the lookups are in
+ * random order (the order of the <nd> of the ways) and 1 in 10 misses.
+ *
+ * usage: node_index_benchmark [nodes] [lookups]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "utilities/node_index.h"
+
+
+namespace {
+
+double
+nanoseconds_since(std::chrono::steady_clock::time_point begin, size_t operations) {
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / static_cast<double>(operations);
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    size_t nodes = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 10000000;
+    size_t lookups = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 10000000;
+
+    std::mt19937_64 random(42);
+    std::vector<int64_t> ids(nodes);
+    int64_t id = 1000000000;
+    for (auto &node_id : ids) {
+        id += 1 + static_cast<int64_t>(random() % 8);
+        node_id = id;
+    }
+
+    std::vector<int64_t> probes(lookups);
+    for (auto &probe : probes) {
+        probe = ids[random() % nodes];
+        if (random() % 10 == 0) probe += 1;
+    }
+
+    for (const std::string type : {"sorted", "dense", "sparse"}) {
+        auto index = osm2pgr::NodeIndex::create(type);
+
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < nodes; ++i) index->add(ids[i], i);
+        index->finish();
+        auto add_ns = nanoseconds_since(begin, nodes);
+
+        size_t found = 0;
+        begin = std::chrono::steady_clock::now();
+        for (const auto probe : probes) {
+            if (index->find(probe) != osm2pgr::NodeIndex::npos) ++found;
+        }
+        auto find_ns = nanoseconds_since(begin, lookups);
+
+        std::cout << type << ":\t"
+            << add_ns << " ns/add\t"
+            << find_ns << " ns/lookup\t"
+            << static_cast<double>(index->memory()) / static_cast<double>(nodes) << " bytes/node\t"
+            << found << " found\n";
+    }
+    return 0;
+}
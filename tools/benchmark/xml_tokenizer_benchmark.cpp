@@ -0,0 +1,171 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by pgRouting developers                            *
+ *   project@pgrouting.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License t &or more details.                        *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+/*
+ * Parses an uncompressed .osm file with expat and with the OSMTokenizer
+ * and compares the throughput and the delivered events.
+ *
+ * usage: xml_tokenizer_benchmark file.osm [repetitions]
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <expat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "parser/XMLParser.h"
+#include "parser/OSMTokenizer.h"
+
+
+namespace {
+
+/*
+ * Counts the events and hashes (FNV-1a) the names and attributes in order
+ */
+class Digest : public xml::XMLParserCallback {
+ public:
+    Digest() : m_events(0), m_hash(14695981039346656037ULL) {}
+
+    void StartElement(const char *name, const char **atts) {
+        ++m_events;
+        add(name);
+        for (; *atts; ++atts) add(*atts);
+        add("");
+    }
+
+    void EndElement(const char *name) {
+        ++m_events;
+        add(name);
+    }
+
+    uint64_t events() const {return m_events;}
+    uint64_t hash() const {return m_hash;}
+
+ private:
+    void add(const char *s) {
+        do {
+            m_hash ^= static_cast<unsigned char>(*s);
+            m_hash *= 1099511628211ULL;
+        } while (*s++);
+    }
+
+    uint64_t m_events;
+    uint64_t m_hash;
+};
+
+
+void start_element(void *data, const char *name, const char **atts) {
+    static_cast<Digest*>(data)->StartElement(name, atts);
+}
+
+void end_element(void *data, const char *name) {
+    static_cast<Digest*>(data)->EndElement(name);
+}
+
+
+bool parse_expat(const char *data, size_t size, Digest &digest) {
+    auto parser = XML_ParserCreate(NULL);
+    XML_SetUserData(parser, &digest);
+    XML_SetElementHandler(parser, start_element, end_element);
+    const size_t window = 64 * 1024 * 1024;
+    bool ok = true;
+    for (size_t offset = 0; ok && offset < size; offset += window) {
+        auto len = std::min(window, size - offset);
+        ok = XML_Parse(parser, data + offset, static_cast<int>(len), offset + len == size) != XML_STATUS_ERROR;
+    }
+    XML_ParserFree(parser);
+    return ok;
+}
+
+
+bool parse_tokenizer(const char *data, size_t size, Digest &digest) {
+    xml::OSMTokenizer tokenizer(digest);
+    return tokenizer.ParseDocument(data, size) == xml::OSMTokenizer::DONE;
+}
+
+
+template <typename Parse>
+double run(const char *label, Parse parse, const char *data, size_t size, int repetitions, Digest &digest) {
+    double best = 0;
+    for (int i = 0; i < repetitions; ++i) {
+        digest = Digest();
+        auto begin = std::chrono::steady_clock::now();
+        if (!parse(data, size, digest)) {
+            std::cerr << label << ": the file was not parsed completely\n";
+            exit(1);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        auto rate = static_cast<double>(size) / (1024.0 * 1024.0) / elapsed.count();
+        if (rate > best) best = rate;
+    }
+    std::cout << label << ":\t" << best << " MB/s\t"
+        << digest.events() << " events\thash " << std::hex << digest.hash() << std::dec << "\n";
+    return best;
+}
+
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " file.osm [repetitions]\n";
+        return 1;
+    }
+    int repetitions = argc > 2 ? std::max(1, atoi(argv[2])) : 3;
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::cerr << "Error opening " << argv[1] << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    auto size = static_cast<size_t>(st.st_size);
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Error mapping " << argv[1] << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    auto data = static_cast<const char*>(map);
+
+    Digest expat_digest;
+    Digest tokenizer_digest;
+    auto expat_rate = run("expat", parse_expat, data, size, repetitions, expat_digest);
+    auto tokenizer_rate = run("tokenizer", parse_tokenizer, data, size, repetitions, tokenizer_digest);
+
+    bool same = expat_digest.events() == tokenizer_digest.events()
+        && expat_digest.hash() == tokenizer_digest.hash();
+    std::cout << "speedup:\t" << tokenizer_rate / expat_rate << "x\n"
+        << "events " << (same ? "identical" : "DIFFERENT") << "\n";
+
+    munmap(map, size);
+    close(fd);
+    return same ? 0 : 1;
+}